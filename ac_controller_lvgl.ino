@@ -6,7 +6,19 @@
 
 #include <SPI.h>
 #include <PubSubClient.h>
+#include <esp_heap_caps.h>
+#include <Preferences.h>
+#include <esp_timer.h>
+#include <esp_vfs_eventfd.h>
+#include <sys/select.h>
+#include <unistd.h>
 #include "src/ac_controller_lvgl.h"
+#include "src/mqtt_status_parser.h"
+#include "src/unit_state_cache.h"
+#include "src/touch_ring.h"
+#include "src/touch_filter.h"
+#include "src/task_messages.h"
+#include "src/idle_time.h"
 #include "config/credentials.h"
 #include "config/ac_units_config.h"
 #include "config/mqtt_config.h"
@@ -14,6 +26,10 @@
 #include "config/ui_config.h"
 #include "config/translations.h"
 
+#if LOOP_LIGHT_SLEEP
+#include <esp_pm.h>
+#endif
+
 // Network and MQTT configuration (loaded from credentials.h)
 const char* ssid = WIFI_SSID;
 const char* password = WIFI_PASSWORD;
@@ -22,13 +38,58 @@ const int mqttPort = MQTT_PORT;
 const char* mqttUser = MQTT_USER;
 const char* mqttPassword = MQTT_PASSWORD;
 
-// Production mode flag
-bool productionMode = PRODUCTION_MODE;
+// Log rings, filled by logWrite() and drained to Serial by logFlush().
+// Each task that logs writes to its own ring (src/spsc_queue.h), so the
+// network task never waits for the UI task or the UART.
+typedef SpscQueue<char, LOG_BUFFER_SIZE> LogRing;
+static LogRing uiLog;      // setup() and loop()
+static LogRing networkLog; // Network task, mqttCallback included
+static TaskHandle_t networkTaskHandle = NULL;
+
+// Format a message into the calling task's log ring. Never waits for the
+// UART; a message that does not fit is dropped whole.
+void logWrite(const char *format, ...) {
+  char line[LOG_LINE_MAX];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  if (length <= 0) return;
+  if (length >= (int)sizeof(line)) length = sizeof(line) - 1; // Cut off
+  
+  LogRing *ring = networkTaskHandle && xTaskGetCurrentTaskHandle() == networkTaskHandle ? &networkLog : &uiLog;
+  spscPushAll(ring, line, length);
+}
+
+// Report the messages a ring dropped once it has drained
+static void logReportDropped(LogRing *ring, uint32_t *reported, const char *task) {
+  uint32_t dropped = ring->dropped.load(std::memory_order_relaxed);
+  if (dropped == *reported || !spscEmpty(ring)) return;
+  logWrite("Log: %u messages from the %s task dropped\n", (unsigned)(dropped - *reported), task);
+  *reported = dropped;
+}
 
-// Debug printing macros - only print if not in production mode
-#define DEBUG_PRINT(x) do { if (!productionMode) Serial.print(x); } while(0)
-#define DEBUG_PRINTLN(x) do { if (!productionMode) Serial.println(x); } while(0)
-#define DEBUG_PRINTF(x, ...) do { if (!productionMode) Serial.printf(x, __VA_ARGS__); } while(0)
+// Move log output to the UART, only as much as its TX buffer takes
+// without blocking. Called every loop(). The rings take turns per
+// message; one cut off by a full UART is finished first, so lines from
+// the two tasks never mix.
+void logFlush() {
+  static LogRing *ring = &uiLog;
+  static uint32_t uiReported = 0;
+  static uint32_t networkReported = 0;
+  int room = Serial.availableForWrite();
+  int empty = 0; // Rings found empty in a row
+  while (room > 0 && empty < 2) {
+    char chunk[64];
+    uint32_t count = spscPopMany(ring, chunk, min(room, (int)sizeof(chunk)));
+    if (count) Serial.write((const uint8_t *)chunk, count);
+    room -= count;
+    empty = count ? 0 : empty + 1;
+    if (count == 0 || chunk[count - 1] == '\n') ring = ring == &uiLog ? &networkLog : &uiLog;
+  }
+  logReportDropped(&uiLog, &uiReported, "UI");
+  logReportDropped(&networkLog, &networkReported, "network");
+}
 
 // Test mode flag - set to true to skip MQTT connection and use dummy data
 bool testMode = false; // Change to false for normal operation
@@ -36,17 +97,103 @@ bool testMode = false; // Change to false for normal operation
 // Create separate SPI instance for touch controller
 SPIClass touchSPI = SPIClass(TOUCH_SPI_INSTANCE);
 
-// Create touchscreen instance with IRQ pin
-XPT2046_Touchscreen ts(XPT2046_CS, XPT2046_IRQ);
+// Create touchscreen instance. The IRQ pin is handled by the touch
+// sampler below; given to the library it would gate getPoint() on its
+// own interrupt flag.
+XPT2046_Touchscreen ts(XPT2046_CS);
 
 // Create display and MQTT instances
 TFT_eSPI tft = TFT_eSPI();
 WiFiClient wifiClient;
 PubSubClient mqttClient(wifiClient);
 
-// LVGL display buffer - configured from hardware config
-static lv_color_t buf1[LVGL_BUFFER_SIZE];
-static lv_color_t buf2[LVGL_BUFFER_SIZE];
+// MQTT link state machine, see mqttLinkStep(). Written by the network
+// task only, read by the UI task for the header icons and the queue.
+std::atomic<MqttLinkState> mqttLinkState(MQTT_LINK_IDLE);
+std::atomic<bool> mqttConnected(false); // mqttClient.connected() as of the last network step
+static uint32_t mqttBackoffMs = MQTT_RECONNECT_DELAY; // Backoff for the next failure, before jitter
+static uint32_t mqttRetryAt = 0;                      // millis() of the next connect attempt
+
+// Outbound command queue. Each unit has one slot per command; queuing a
+// command again replaces the value and restarts its delay, so a burst of
+// changes only puts the last value on the wire. After publishing, the slot
+// tracks the command until a status message confirms it; until then status
+// values for that field are held back so they cannot revert the UI.
+struct QueuedCommand {
+  bool queued;
+  bool bulk;          // Queued value is part of the running all units batch
+  bool sentBulk;      // In-flight value is part of it
+  int16_t value;      // Power 0/1, enum index, or temperature in tenths of a degree
+  uint32_t dueAt;     // millis() at which it is published
+  bool inFlight;      // Published, not confirmed yet
+  int16_t sentValue;
+  uint16_t seq;       // Sequence number of the in-flight command
+  uint32_t sentAt;    // millis() of the handover to the network task, which publishes right away
+};
+static QueuedCommand commandQueue[numUnits][AC_COMMAND_COUNT];
+static uint32_t commandsCoalesced = 0; // Queued commands replaced before they were sent
+static uint16_t commandSeq = 0;
+CommandStats commandStats = {};
+LatencyHistogram unitLatency[numUnits]; // Publish to confirming status, per unit
+
+// Publish rate limit, a token bucket: COMMAND_RATE_BURST commands go out
+// at once, after that one per COMMAND_RATE_INTERVAL
+static uint8_t commandTokens = COMMAND_RATE_BURST;
+static uint32_t commandTokenAt = 0;
+
+// All units batch started by setAllACPower()
+static int bulkRemaining = 0; // Batch commands not confirmed or timed out yet
+static int bulkTimedOut = 0;
+static uint32_t bulkStartedAt = 0;
+
+// A batch command got its confirmation or timed out; the batch is done
+// when none is left
+static void bulkCommandDone(QueuedCommand *cmd, bool confirmed, uint32_t now) {
+  if (!cmd->sentBulk) return;
+  cmd->sentBulk = false;
+  if (!confirmed) bulkTimedOut++;
+  if (--bulkRemaining == 0) {
+    LOG_INFO("All units batch done in %u ms, %d not confirmed\n", (unsigned)(now - bulkStartedAt), bulkTimedOut);
+  }
+}
+
+// Network task <-> UI task, see src/task_messages.h
+static NetEventQueue netEvents;
+static NetCommandQueue netCommands;
+static void networkTask(void *arg);
+
+// Wake-ups. The UI task waits for a task notification, given by the touch
+// sampler and by the network task after pushing an event. The network task
+// waits in select() on the MQTT socket and an eventfd, which the UI task
+// signals after handing over commands.
+static TaskHandle_t uiTaskHandle = NULL;
+static int networkWakeFd = -1;
+static IdleTime uiIdle;
+static IdleTime networkIdle;
+
+static void wakeUiTask() {
+  if (uiTaskHandle) xTaskNotifyGive(uiTaskHandle);
+}
+
+static void wakeNetworkTask() {
+  if (networkWakeFd < 0) return;
+  uint64_t one = 1;
+  write(networkWakeFd, &one, sizeof(one));
+}
+
+// Enter a link state and have the UI task show it in the header right away
+static void setMqttLinkState(MqttLinkState state) {
+  mqttLinkState = state;
+  NetEvent event = {};
+  event.type = NET_EVENT_LINK;
+  spscPush(&netEvents, event);
+  wakeUiTask();
+}
+
+// LVGL display buffers - allocated in setupDrawBuffers() from hardware config
+static uint8_t *buf1 = NULL;
+static uint8_t *buf2 = NULL;
+static uint32_t bufBytes = 0;
 
 // LVGL display driver
 static lv_display_t *display;
@@ -66,6 +213,8 @@ lv_obj_t *mainScreen = NULL;
 lv_obj_t *unitDetailScreen = NULL;
 lv_obj_t *loadingScreen = NULL;
 lv_obj_t *unitScreen = NULL;
+lv_obj_t *diagnosticsScreen = NULL; // Created on first use, see showDiagnosticsScreen()
+lv_obj_t *calibrationScreen = NULL; // Created on first use, see showCalibrationScreen()
 
 // LVGL objects for main screen
 lv_obj_t *mainTitle = NULL;
@@ -96,115 +245,481 @@ lv_obj_t *swingModal = NULL;
 
 // Function declarations are now in ac_controller_lvgl.h
 
-// LVGL display flush callback
+// Number of flush calls, used by the buffer benchmark
+static uint32_t flushCount = 0;
+
+#if LVGL_FLUSH_DMA
+// DMA flush state: set while a stripe is on the wire
+static volatile bool flushInFlight = false;
+static uint32_t flushWaitMicros = 0; // Time LVGL spent waiting for a transfer to finish
+static bool flushUseDma = true;      // Cleared when the draw buffer is not DMA capable (PSRAM)
+
+// Transfer complete: release the bus and hand the buffer back to LVGL
+static void flush_transfer_complete(lv_display_t *disp) {
+  tft.endWrite();
+  flushInFlight = false;
+  lv_display_flush_ready(disp);
+}
+
+// Called by LVGL when it needs a buffer that is still being transferred
+static void my_disp_flush_wait(lv_display_t *disp) {
+  if (!flushInFlight) return;
+  uint32_t start = micros();
+  tft.dmaWait();
+  flushWaitMicros += micros() - start;
+  flush_transfer_complete(disp);
+}
+
+// Polled from loop(): completes a finished transfer without blocking
+// (TFT_eSPI has no DMA completion interrupt we can hook). While one is
+// on the wire loop() only waits a tick at a time.
+static void poll_flush_complete() {
+  if (flushInFlight && !tft.dmaBusy()) {
+    flush_transfer_complete(display);
+  }
+}
+#endif
+
+// LVGL display flush callback. With DMA the transfer is started and the
+// callback returns immediately, so LVGL can render the next stripe into
+// the other buffer meanwhile.
 static void my_disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
   uint32_t w = (area->x2 - area->x1 + 1);
   uint32_t h = (area->y2 - area->y1 + 1);
+  flushCount++;
 
   tft.startWrite();
   tft.setAddrWindow(area->x1, area->y1, w, h);
+#if LVGL_FLUSH_DMA
+  if (flushUseDma) {
+    flushInFlight = true;
+    tft.pushPixelsDMA((uint16_t *)px_map, w * h);
+    return;
+  }
+#endif
   tft.pushColors((uint16_t *)px_map, w * h, true);
   tft.endWrite();
 
   lv_display_flush_ready(disp);
 }
 
-// Global variables to store touch state
-static bool g_is_touched = false;
-static uint16_t g_touch_x = 0;
-static uint16_t g_touch_y = 0;
-static bool g_processing_touch = false; // Flag to prevent recursive touch processing
+// Free the current draw buffers
+static void freeDrawBuffers() {
+  heap_caps_free(buf1);
+  heap_caps_free(buf2);
+  buf1 = NULL;
+  buf2 = NULL;
+  bufBytes = 0;
+}
 
-// Direct touchpad read callback for LVGL v9.x
-static void my_touchpad_read(lv_indev_t *indev, lv_indev_data_t *data) {
-  static uint16_t last_x = 0;
-  static uint16_t last_y = 0;
-  static bool was_touched = false;
-  
-  // Use global touch state first (set in the main loop)
-  if (g_is_touched) {
-    // Map raw touch coordinates to screen coordinates
-    uint16_t x = map(g_touch_x, TOUCH_RAW_MIN, TOUCH_RAW_MAX, 0, TFT_WIDTH);
-    uint16_t y = map(g_touch_y, TOUCH_RAW_MIN, TOUCH_RAW_MAX, 0, TFT_HEIGHT);
-    
-    // Ensure coordinates are within screen boundaries
-    x = constrain(x, 0, TFT_WIDTH-1);
-    y = constrain(y, 0, TFT_HEIGHT-1);
-    
-    // Set the touch state for LVGL
-    data->state = LV_INDEV_STATE_PRESSED;
-    data->point.x = x;
-    data->point.y = y;
-    
-    // Store last position
-    last_x = x;
-    last_y = y;
-    was_touched = true;
-    
-    // Debug output removed
+// Allocate draw buffers of the given size in pixels. Internal RAM buffers
+// are DMA capable; PSRAM buffers are not, so DMA flushing is turned off.
+static bool allocDrawBuffers(uint32_t pixels, bool doubleBuffer, bool usePsram) {
+  uint32_t bytes = pixels * LVGL_BUFFER_PIXEL_SIZE;
+  uint32_t caps = usePsram ? MALLOC_CAP_SPIRAM : (MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  
+  freeDrawBuffers();
+  buf1 = (uint8_t *)heap_caps_malloc(bytes, caps);
+  if (doubleBuffer) {
+    buf2 = (uint8_t *)heap_caps_malloc(bytes, caps);
+  }
+  if (buf1 == NULL || (doubleBuffer && buf2 == NULL)) {
+    freeDrawBuffers();
+    return false;
+  }
+  bufBytes = bytes;
+#if LVGL_FLUSH_DMA
+  flushUseDma = !usePsram;
+#endif
+  return true;
+}
+
+// Allocate the draw buffers for LVGL_BUFFER_STRATEGY
+static void setupDrawBuffers() {
+#if LVGL_BUFFER_STRATEGY == LVGL_BUFFER_FULL_FRAME
+  if (psramFound() && allocDrawBuffers(TFT_WIDTH * TFT_HEIGHT, false, true)) {
+    Serial.println("Draw buffer: full frame in PSRAM");
     return;
   }
+  Serial.println("Draw buffer: no PSRAM for full frame, using 1/10 screen");
+#endif
+  if (!allocDrawBuffers(LVGL_BUFFER_SIZE, true, false)) {
+    Serial.println("ERROR: Draw buffer allocation failed, using 1/10 screen single buffer");
+    allocDrawBuffers(TFT_WIDTH * TFT_HEIGHT / 10, false, false);
+  }
+  Serial.printf("Draw buffer: %u bytes x%d\n", bufBytes, buf2 ? 2 : 1);
+}
+
+#if LVGL_BUFFER_BENCHMARK
+// Render each screen with every candidate buffer size and report
+// flushes per frame and ms per frame, then restore the configured buffers
+static void runBufferBenchmark() {
+  const uint16_t candidateLines[] = {3, 10, TFT_HEIGHT / 10, TFT_HEIGHT / 4, TFT_HEIGHT};
+  lv_obj_t *screens[] = {loadingScreen, mainScreen, unitScreen};
+  const char *screenNames[] = {"loading", "main", "unit"};
+  lv_obj_t *previousScreen = lv_scr_act();
   
-  // If we get here, check the touchscreen directly as a backup
-  bool irq_active = (digitalRead(XPT2046_IRQ) == LOW);
-  
-  if (irq_active && ts.touched()) {
-    TS_Point p = ts.getPoint();
-    
-    // Map raw touch coordinates to screen coordinates
-    uint16_t x = map(p.x, TOUCH_RAW_MIN, TOUCH_RAW_MAX, 0, TFT_WIDTH);
-    uint16_t y = map(p.y, TOUCH_RAW_MIN, TOUCH_RAW_MAX, 0, TFT_HEIGHT);
-    
-    // Ensure coordinates are within screen boundaries
-    x = constrain(x, 0, TFT_WIDTH-1);
-    y = constrain(y, 0, TFT_HEIGHT-1);
-    
-    // Set the touch state for LVGL
-    data->state = LV_INDEV_STATE_PRESSED;
-    data->point.x = x;
-    data->point.y = y;
-    
-    // Store last position
-    last_x = x;
-    last_y = y;
-    was_touched = true;
-    
-    // Debug output removed
+  Serial.println("=== BUFFER BENCHMARK START ===");
+  Serial.println("lines,screen,flushes,ms");
+  for (uint8_t c = 0; c < sizeof(candidateLines) / sizeof(candidateLines[0]); c++) {
+    uint16_t lines = candidateLines[c];
+    bool fullFrame = (lines == TFT_HEIGHT);
+    if (fullFrame && !psramFound()) continue;
+    if (!allocDrawBuffers(TFT_WIDTH * lines, !fullFrame, fullFrame)) {
+      Serial.print(lines);
+      Serial.println(",-,allocation failed,-");
+      continue;
+    }
+    lv_display_set_buffers(display, buf1, buf2, bufBytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
     
-    // REMOVED recursive calls to prevent stack overflow
+    for (uint8_t i = 0; i < 3; i++) {
+      lv_scr_load(screens[i]);
+      lv_obj_invalidate(screens[i]);
+      flushCount = 0;
+      uint32_t start = micros();
+      lv_refr_now(display);
+#if LVGL_FLUSH_DMA
+      my_disp_flush_wait(display); // Include the last transfer in the frame time
+#endif
+      uint32_t elapsed = micros() - start;
+      Serial.printf("%u,%s,%u,%.2f\n", lines, screenNames[i], flushCount, elapsed / 1000.0);
+    }
   }
+  Serial.println("=== BUFFER BENCHMARK END ===");
   
-  // No touch detected, set to released state
-  data->state = LV_INDEV_STATE_RELEASED;
+  setupDrawBuffers();
+  lv_display_set_buffers(display, buf1, buf2, bufBytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_scr_load(previousScreen);
+}
+#endif
+
+// Touch acquisition. The pen interrupt only starts a periodic esp_timer;
+// its callback reads the controller TOUCH_SAMPLE_RATE times a second and
+// pushes the samples into touchRing until the pen lifts, then stops the
+// timer again. Without a touch there is no SPI traffic on the touch bus.
+// A spurious edge (GPIO36 has those while WiFi starts) costs one read
+// that finds the pen up.
+static TouchRing touchRing;
+static esp_timer_handle_t touchSampleTimer = NULL;
+static volatile bool touchSampling = false;
+
+static void IRAM_ATTR touchIrqHandler() {
+  if (touchSampling) return; // Edges caused by the conversions themselves
+  touchSampling = true;
+  esp_timer_start_periodic(touchSampleTimer, 1000000 / TOUCH_SAMPLE_RATE);
+}
+
+// Runs in the esp_timer task, the only place that talks to the controller
+static void touchSampleCallback(void *arg) {
+  TouchSample sample;
+  TS_Point p = ts.getPoint();
+  sample.down = ts.touched(); // Same reading, the library does not transfer again within 3 ms
+  sample.x = p.x;
+  sample.y = p.y;
+  sample.z = p.z;
+  sample.at = millis();
+  spscPush(&touchRing, sample);
+  wakeUiTask();
   
-  // Use last position for release state
-  if (was_touched) {
-    data->point.x = last_x;
-    data->point.y = last_y;
-    was_touched = false;
-    // Touch release debug output removed
+  if (!sample.down) {
+    esp_timer_stop(touchSampleTimer);
+    touchSampling = false;
+    // A new touch that started during this read has no edge left to wake us
+    if (digitalRead(XPT2046_IRQ) == LOW) touchIrqHandler();
   }
 }
 
-// LVGL timer callback for updating data
+static void initTouchSampling() {
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = touchSampleCallback;
+  timerArgs.name = "touch";
+  esp_timer_create(&timerArgs, &touchSampleTimer);
+  pinMode(XPT2046_IRQ, INPUT);
+  attachInterrupt(digitalPinToInterrupt(XPT2046_IRQ), touchIrqHandler, FALLING);
+}
+
+// Raw to screen transform, the straight default until loadTouchCalibration()
+TouchCalibration touchCalibration;
+TouchCalPoint touchLastRaw = {0, 0};
+static Preferences touchPrefs;
+
+static void loadTouchCalibration() {
+  uint8_t record[TOUCH_CAL_RECORD_SIZE];
+  touchCalibrationDefault(&touchCalibration);
+  touchPrefs.begin(TOUCH_CAL_NAMESPACE, false);
+  size_t length = touchPrefs.getBytes(TOUCH_CAL_KEY, record, sizeof(record));
+  if (decodeTouchCalibration(record, length, &touchCalibration)) {
+    LOG_INFO("Touch calibration loaded\n");
+  } else {
+    LOG_WARN("No touch calibration stored, using TOUCH_RAW_MIN/MAX\n");
+  }
+}
+
+bool saveTouchCalibration(const TouchCalibration *cal) {
+  uint8_t record[TOUCH_CAL_RECORD_SIZE];
+  size_t length = encodeTouchCalibration(cal, record);
+  return touchPrefs.putBytes(TOUCH_CAL_KEY, record, length) == length;
+}
+
+// Filtered points waiting for LVGL. One raw sample can complete a
+// point and a release at once, LVGL takes them one per call.
+static TouchFilter touchFilter;
+static TouchSample touchPending[2];
+static uint8_t touchPendingCount = 0;
+static uint8_t touchPendingNext = 0;
+
+// LVGL input read callback. Drains the touch ring through touchFilter
+// and hands out one filtered sample per call; while more wait,
+// continue_reading makes LVGL call again in the same read cycle so none
+// of them is skipped.
+static void my_touchpad_read(lv_indev_t *indev, lv_indev_data_t *data) {
+  static lv_point_t last_point = {0, 0};
+  static bool pressed = false;
+  TouchSample raw;
+  
+  if (touchPendingNext == touchPendingCount) {
+    touchPendingCount = touchPendingNext = 0;
+    while (touchPendingCount == 0 && spscPop(&touchRing, &raw)) {
+#if TOUCH_TRACE
+      if (raw.down) logWrite("touch %u %d %d %d\n", (unsigned)raw.at, raw.x, raw.y, raw.z);
+      else logWrite("touch %u up\n", (unsigned)raw.at);
+#endif
+      touchPendingCount = touchFilterFeed(&touchFilter, raw, touchPending);
+    }
+  }
+  
+  if (touchPendingNext < touchPendingCount) {
+    const TouchSample &sample = touchPending[touchPendingNext++];
+    pressed = sample.down;
+    if (sample.down) {
+      touchLastRaw.x = sample.x;
+      touchLastRaw.y = sample.y;
+      
+      // Map raw touch coordinates to screen coordinates
+      int32_t x, y;
+      touchCalibrationApply(&touchCalibration, sample.x, sample.y, &x, &y);
+      
+      // Ensure coordinates are within screen boundaries
+      last_point.x = constrain(x, 0, TFT_WIDTH - 1);
+      last_point.y = constrain(y, 0, TFT_HEIGHT - 1);
+    }
+  }
+  data->continue_reading = touchPendingNext < touchPendingCount || !spscEmpty(&touchRing);
+  
+  // A release reports the last pressed position
+  data->state = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+  data->point = last_point;
+}
+
+// LVGL timer callback for simulating unit data in test mode.
+// Screens follow the unit subjects, so no periodic repaint is needed.
 static void update_data_timer(lv_timer_t *timer) {
-  // Update all unit data from MQTT
   updateAllUnits();
+}
+
+// Status topics, built once by initStatusTopics()
+static char statusTopicPool[numUnits * MQTT_TOPIC_MAX_LENGTH]; // All topics back to back, NUL separated
+static const char *statusTopics[numUnits];        // Topic of each unit, points into the pool
+static uint8_t statusTopicLengths[numUnits];
+// Status messages for units not in ac_units_config.h, which the wildcard
+// subscription also delivers. Counted by the network task.
+static std::atomic<uint32_t> unknownStatusMessages(0);
+
+// Open addressing table from topic hash to unit index, at least twice
+// the number of units so probes stay short
+static constexpr int nextPowerOfTwo(int n) {
+  return n <= 1 ? 1 : 2 * nextPowerOfTwo((n + 1) / 2);
+}
+static const int TOPIC_TABLE_SIZE = nextPowerOfTwo(numUnits) * 2;
+static int8_t topicTable[TOPIC_TABLE_SIZE];
+static_assert(numUnits <= 127, "topicTable stores unit indexes as int8_t");
+
+// FNV-1a hash of a topic, also returns its length
+static uint32_t topicHash(const char *topic, size_t *length) {
+  uint32_t hash = 2166136261u;
+  const char *p = topic;
+  while (*p) {
+    hash = (hash ^ (uint8_t)*p++) * 16777619u;
+  }
+  *length = p - topic;
+  return hash;
+}
+
+// Generate every unit's status topic once and index them by hash
+void initStatusTopics() {
+  memset(topicTable, -1, sizeof(topicTable));
+  char *next = statusTopicPool;
+  for (int i = 0; i < numUnits; i++) {
+    generateStatusTopic(next, acUnits[i].mqttTopic);
+    size_t length;
+    uint32_t hash = topicHash(next, &length);
+    statusTopics[i] = next;
+    statusTopicLengths[i] = length;
+    next += length + 1;
+    
+    uint32_t slot = hash & (TOPIC_TABLE_SIZE - 1);
+    while (topicTable[slot] >= 0) slot = (slot + 1) & (TOPIC_TABLE_SIZE - 1);
+    topicTable[slot] = i;
+  }
+  LOG_DEBUG("Status topics: %u bytes for %d units\n", (unsigned)(next - statusTopicPool), numUnits);
+}
+
+// Unit index for a status topic, -1 if it is not one of ours.
+// Costs one pass over the topic plus a compare, independent of numUnits.
+int findUnitByStatusTopic(const char *topic) {
+  size_t length;
+  uint32_t slot = topicHash(topic, &length) & (TOPIC_TABLE_SIZE - 1);
+  while (topicTable[slot] >= 0) {
+    int unitIndex = topicTable[slot];
+    if (statusTopicLengths[unitIndex] == length && memcmp(statusTopics[unitIndex], topic, length) == 0) {
+      return unitIndex;
+    }
+    slot = (slot + 1) & (TOPIC_TABLE_SIZE - 1);
+  }
+  return -1;
+}
+
+// Unit state snapshot in NVS, see src/unit_state_cache.h. Changes are
+// collected for UNIT_STATE_SAVE_DELAY and then written as one record,
+// and only when the record differs from what is already in flash.
+static Preferences statePrefs;
+static uint8_t savedUnitState[unitStateRecordSize(numUnits)]; // Record currently in flash
+static bool unitStatePending = false;
+static uint32_t unitStatePendingSince = 0;
+
+// Load the snapshot of the last run before anything is rendered. Without
+// one, temperatures stay unknown until the first status message.
+static void restoreUnitState() {
+  for (int i = 0; i < numUnits; i++) {
+    acUnits[i].currentTemp = AC_TEMP_UNKNOWN;
+  }
   
-  // Update current screen based on which one is active
-  lv_obj_t *current_screen = lv_scr_act();
+  statePrefs.begin(UNIT_STATE_NAMESPACE, false);
+  size_t length = statePrefs.getBytes(UNIT_STATE_KEY, savedUnitState, sizeof(savedUnitState));
+  if (decodeUnitState(savedUnitState, length, acUnits, numUnits)) {
+    LOG_INFO("Unit state restored (%u bytes)\n", (unsigned)length);
+  } else {
+    memset(savedUnitState, 0, sizeof(savedUnitState));
+    LOG_INFO("No usable unit state snapshot, waiting for status messages\n");
+  }
+}
+
+// Write the snapshot once the pending changes are old enough
+static void saveUnitStateStep(uint32_t now) {
+  if (!unitStatePending || now - unitStatePendingSince < UNIT_STATE_SAVE_DELAY) return;
+  unitStatePending = false;
   
-  if (current_screen == mainScreen) {
-    updateMainScreen();
-  } else if (current_screen == unitScreen && selectedUnit >= 0) {
-    updateUnitScreen(selectedUnit);
+  uint8_t record[sizeof(savedUnitState)];
+  size_t length = encodeUnitState(acUnits, numUnits, record);
+  if (memcmp(record, savedUnitState, length) == 0) return;
+  if (statePrefs.putBytes(UNIT_STATE_KEY, record, length) == length) {
+    memcpy(savedUnitState, record, length);
+    LOG_DEBUG("Unit state saved (%u bytes)\n", (unsigned)length);
+  } else {
+    LOG_ERROR("ERROR: Saving unit state failed\n");
   }
 }
 
+// Boot pipeline. setup() runs the local stages, the network stages are
+// advanced by bootStep() in the network task while the main screen is
+// already in use.
+enum BootStage {
+  BOOT_DISPLAY,
+  BOOT_TOUCH,
+  BOOT_SCREENS,
+  BOOT_WIFI,
+  BOOT_MQTT,
+  BOOT_SUBSCRIBE,
+  BOOT_DONE
+};
+static const char *bootStageNames[BOOT_DONE] = {"display", "touch", "screens", "wifi", "mqtt", "subscribe"};
+static BootStage bootStage = BOOT_DISPLAY;
+static uint32_t bootStageMillis[BOOT_DONE]; // millis() at which each stage finished
+static uint32_t wifiAttemptStart = 0;
+
+// Log a finished stage with its time since power-on and its own duration
+static void bootStageDone(BootStage stage) {
+  uint32_t now = millis();
+  uint32_t previous = stage == BOOT_DISPLAY ? 0 : bootStageMillis[stage - 1];
+  bootStageMillis[stage] = now;
+  bootStage = (BootStage)(stage + 1);
+  LOG_INFO("Boot: %s ready at %u ms (+%u ms)\n", bootStageNames[stage],
+           (unsigned)now, (unsigned)(now - previous));
+  if (bootStage == BOOT_DONE) {
+    LOG_INFO("Boot: interactive after %u ms, connected after %u ms\n",
+             (unsigned)bootStageMillis[BOOT_SCREENS], (unsigned)now);
+  }
+}
+
+// Advance the network stages, called once per network task step before
+// mqttLinkStep()
+static void bootStep(uint32_t now) {
+  switch (bootStage) {
+    case BOOT_WIFI:
+      if (WiFi.status() == WL_CONNECTED) {
+        LOG_INFO("WiFi connected, IP address: %s\n", WiFi.localIP().toString().c_str());
+        LOG_INFO("Attempting to connect to %s:%d\n", mqttBroker, mqttPort);
+        setMqttLinkState(MQTT_LINK_CONNECTING);
+        bootStageDone(BOOT_WIFI);
+      } else if (now - wifiAttemptStart > WIFI_CONNECTION_TIMEOUT) {
+        LOG_WARN("WiFi connection failed, retrying\n");
+        WiFi.disconnect();
+        WiFi.begin(ssid, password);
+        wifiAttemptStart = now;
+      }
+      break;
+      
+    case BOOT_MQTT:
+      // Past connect() once the link starts subscribing
+      if (mqttLinkState == MQTT_LINK_SUBSCRIBING ||
+          (mqttLinkState == MQTT_LINK_IDLE && mqttClient.connected())) {
+        bootStageDone(BOOT_MQTT);
+      }
+      break;
+      
+    case BOOT_SUBSCRIBE:
+      if (mqttLinkState == MQTT_LINK_IDLE && mqttClient.connected()) {
+        bootStageDone(BOOT_SUBSCRIBE);
+      }
+      break;
+      
+    default:
+      break;
+  }
+}
+
+static uint32_t lvTickMillis() {
+  return millis();
+}
+
+#if LOOP_LIGHT_SLEEP
+// Let the idle task scale the CPU clock and enter light sleep while every
+// task waits. Light sleep needs CONFIG_FREERTOS_USE_TICKLESS_IDLE in the
+// sdkconfig; without it only the clock scaling is used. The pen IRQ is no
+// wake source, as a GPIO wake-up would take over its edge interrupt, so
+// loop() checks the pin after each wait instead.
+static void initLightSleep() {
+  esp_pm_config_t pm = {};
+  pm.max_freq_mhz = getCpuFrequencyMhz();
+  pm.min_freq_mhz = 80; // Lowest clock WiFi works with
+  pm.light_sleep_enable = true;
+  if (esp_pm_configure(&pm) == ESP_OK) {
+    LOG_INFO("Automatic light sleep enabled\n");
+    return;
+  }
+  pm.light_sleep_enable = false;
+  if (esp_pm_configure(&pm) == ESP_OK) {
+    LOG_WARN("Light sleep not supported by this build, CPU clock scaling only\n");
+  } else {
+    LOG_WARN("Power management not supported by this build\n");
+  }
+}
+#endif
+
 void setup() {
   Serial.begin(SERIAL_BAUD_RATE);
-  delay(1000); // Allow serial to initialize
-  DEBUG_PRINTLN(TXT_DEBUG_AC_STARTING);
+  Serial.println(TXT_DEBUG_AC_STARTING);
+  uiTaskHandle = xTaskGetCurrentTaskHandle(); // setup() and loop() run in the same task
   
   // Set backlight pin as output and turn it on
   pinMode(TFT_BL, OUTPUT);
@@ -213,19 +728,15 @@ void setup() {
   // Initialize display
   tft.init();
   tft.setRotation(TFT_ROTATION); // Portrait mode from config
-  
-  // Initialize touchscreen with custom SPI - exactly as in the working touch test
-  touchSPI.begin(XPT2046_CLK, XPT2046_MISO, XPT2046_MOSI, XPT2046_CS);
-  if (!ts.begin(touchSPI)) {
-    DEBUG_PRINTLN(TXT_DEBUG_TOUCH_INIT_FAILED);
-  } else {
-    DEBUG_PRINTLN(TXT_DEBUG_TOUCH_INIT_SUCCESS);
-  }
-  ts.setRotation(TFT_ROTATION); // Match display rotation
+#if LVGL_FLUSH_DMA
+  tft.initDMA();
+  tft.setSwapBytes(true); // pushPixelsDMA swaps in place, matching pushColors(..., true)
+#endif
   
   // Initialize LVGL
   Serial.println("Initializing LVGL...");
   lv_init();
+  lv_tick_set_cb(lvTickMillis); // LVGL reads the time itself, loop() need not wake to count ticks
   Serial.println("LVGL initialized successfully");
   
   // Initialize display for portrait mode
@@ -233,8 +744,12 @@ void setup() {
   display = lv_display_create(TFT_WIDTH, TFT_HEIGHT);
   Serial.println("Setting display flush callback...");
   lv_display_set_flush_cb(display, my_disp_flush);
+#if LVGL_FLUSH_DMA
+  lv_display_set_flush_wait_cb(display, my_disp_flush_wait);
+#endif
   Serial.println("Setting display buffers...");
-  lv_display_set_buffers(display, buf1, buf2, sizeof(buf1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+  setupDrawBuffers();
+  lv_display_set_buffers(display, buf1, buf2, bufBytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
   
   // Make sure we're in portrait mode
   Serial.println("Setting display rotation...");
@@ -245,6 +760,18 @@ void setup() {
   Serial.print(TFT_WIDTH);
   Serial.print("x");
   Serial.println(TFT_HEIGHT);
+  bootStageDone(BOOT_DISPLAY);
+  
+  // Initialize touchscreen with custom SPI - exactly as in the working touch test
+  touchSPI.begin(XPT2046_CLK, XPT2046_MISO, XPT2046_MOSI, XPT2046_CS);
+  if (!ts.begin(touchSPI)) {
+    Serial.println(TXT_DEBUG_TOUCH_INIT_FAILED);
+  } else {
+    Serial.println(TXT_DEBUG_TOUCH_INIT_SUCCESS);
+  }
+  ts.setRotation(TFT_ROTATION); // Match display rotation
+  initTouchSampling();
+  loadTouchCalibration();
   
   // Initialize input device with enhanced configuration for LVGL v9.x
   Serial.println("Creating input device...");
@@ -277,6 +804,18 @@ void setup() {
   } else {
     Serial.println("ERROR: Touch input device type verification failed!");
   }
+  bootStageDone(BOOT_TOUCH);
+  
+  // Last known state first, so the subjects and screens start from it
+  if (!testMode) {
+    restoreUnitState();
+  }
+  
+  // Create one LVGL subject per unit field before any screen binds to them
+  initUnitSubjects();
+  
+  // Build the status topic table used for subscribing and matching
+  initStatusTopics();
   
   // Create LVGL screens
   Serial.println("Creating loading screen...");
@@ -289,10 +828,9 @@ void setup() {
 //  createUnitDetailScreen();
   Serial.println("All screens created successfully");
   
-  // Show loading screen initially
-  Serial.println("Loading initial screen...");
-  lv_scr_load(loadingScreen);
-  Serial.println("Initial screen loaded");
+#if LVGL_BUFFER_BENCHMARK
+  runBufferBenchmark();
+#endif
   
   if (testMode) {
     // Skip WiFi and MQTT connection in test mode
@@ -307,331 +845,308 @@ void setup() {
       acUnits[i].fanSpeed = i % 4; // Cycle through fan speeds
       acUnits[i].swingMode = i % 5; // Some with swing on
       acUnits[i].targetTemp = 23 + (i % 5); // Different target temps
+      publishUnitFields(i, AC_FIELD_MASK_ALL);
     }
     
-    // Create timer for periodic UI updates even in test mode
+    // Create timer for the test mode temperature simulation
     lv_timer_create(update_data_timer, DATA_UPDATE_INTERVAL, NULL);
     
-    // Show main screen immediately
-    lv_scr_load(mainScreen);
-    
-    // Explicitly update the main screen to show the AC units
-    updateMainScreen();
-    
     // Update connection status to show test mode
     lv_label_set_text(connectionStatus, "TEST MODE - No MQTT Connection");
     lv_obj_set_style_text_color(connectionStatus, lv_color_hex(0xFFAA00), LV_PART_MAIN | LV_STATE_DEFAULT);
   } else {
-    // Normal operation mode - connect to WiFi and MQTT
+    // MQTT needs no network to be configured, mqttLinkStep() connects later
+    mqttClient.setServer(mqttBroker, mqttPort);
+    mqttClient.setCallback(mqttCallback);
+    mqttClient.setSocketTimeout(MQTT_SOCKET_TIMEOUT);
+  }
+  
+  // The main screen is usable right away with the restored state, cards
+  // fill in through the unit subjects as status messages arrive
+  lv_scr_load(mainScreen);
+  updateMainScreen();
+  // A finger on the screen during boot asks for calibration, for when the
+  // stored one is too far off to reach the button on the diagnostics screen
+  if (digitalRead(XPT2046_IRQ) == LOW) {
+    LOG_INFO("Touch held during boot, starting calibration\n");
+    showCalibrationScreen();
+  }
+  bootStageDone(BOOT_SCREENS);
+  
+  if (testMode) {
+    // Skip WiFi and MQTT connection in test mode
+    bootStage = BOOT_DONE;
+  } else {
+    // bootStep() waits for WiFi without blocking, then starts MQTT.
+    // From here on only the network task touches WiFi and mqttClient.
     Serial.println("Connecting to WiFi...");
     WiFi.begin(ssid, password);
-    
-    // Wait for connection with timeout
-    int wifiTimeout = 0;
-    while (WiFi.status() != WL_CONNECTED && wifiTimeout < 20) {
-      delay(500);
-      Serial.print(".");
-      wifiTimeout++;
-      lv_timer_handler(); // Keep LVGL running during connection
-    }
-    
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.println("WiFi connected");
-      Serial.println("IP address: " + WiFi.localIP().toString());
-      
-      // Connect to MQTT broker
-      Serial.println("Connecting to MQTT broker...");
-      
-      Serial.print("Attempting to connect to ");
-      Serial.print(mqttBroker);
-      Serial.print(":");
-      Serial.println(mqttPort);
-      
-      mqttClient.setServer(mqttBroker, mqttPort);
-      mqttClient.setCallback(mqttCallback);
-      
-      while (!mqttClient.connected()) {
-        Serial.println("Attempting MQTT connection...");
-        if (mqttClient.connect("ESP32Client", mqttUser, mqttPassword)) {
-          Serial.println("MQTT connection successful!");
-          
-          // Subscribe to all AC unit status topics
-          for (int i = 0; i < numUnits; i++) {
-            char statusTopic[MQTT_TOPIC_MAX_LENGTH];
-            generateStatusTopic(statusTopic, acUnits[i].mqttTopic);
-            mqttClient.subscribe(statusTopic);
-            DEBUG_PRINT("Subscribed to: ");
-            DEBUG_PRINTLN(statusTopic);
-          }
-          
-          // Wait for initial status updates to arrive naturally from Home Assistant
-          // Removed: force status polling as it can cause race conditions
-          delay(1000); // Wait a bit for subscriptions to be processed
-        } else {
-          Serial.print("MQTT connection failed, rc=");
-          Serial.print(mqttClient.state());
-          Serial.println(" try again in 5 seconds");
-          delay(5000);
-        }
-      }
-      
-      // Initialize AC units with default values
-      for (int i = 0; i < numUnits; i++) {
-        updateUnitData(i);
-      }
-      
-      // Create timer for periodic updates
-      lv_timer_create(update_data_timer, DATA_UPDATE_INTERVAL, NULL);
-      
-      // Show main screen
-      lv_scr_load(mainScreen);
-    } else {
-      Serial.println("WiFi connection failed");
-      // Update loading screen to show error
-      lv_obj_t *errorLabel = lv_label_create(loadingScreen);
-      lv_label_set_text(errorLabel, "WiFi connection failed");
-      lv_obj_align(errorLabel, LV_ALIGN_CENTER, 0, 40);
-    }
+    wifiAttemptStart = millis();
+    esp_vfs_eventfd_config_t eventfdConfig = {};
+    eventfdConfig.max_fds = 1;
+    esp_vfs_eventfd_register(&eventfdConfig);
+    networkWakeFd = eventfd(0, 0);
+    xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK, NULL, NETWORK_TASK_PRIORITY,
+                            &networkTaskHandle, NETWORK_TASK_CORE);
   }
+#if LOOP_LIGHT_SLEEP
+  initLightSleep();
+#endif
+}
+
+// Milliseconds until `last + interval`, 0 when already due
+static uint32_t timeUntil(uint32_t now, uint32_t last, uint32_t interval) {
+  uint32_t elapsed = now - last;
+  return elapsed >= interval ? 0 : interval - elapsed;
+}
+
+// Block the UI task for at most `ms`, or until the touch sampler or the
+// network task gives a notification. With LOOP_LIGHT_SLEEP the idle task
+// can put the chip in light sleep meanwhile.
+static void loopWait(uint32_t ms) {
+  uint32_t start = micros();
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms));
+  idleTimeAdd(&uiIdle, start, micros());
 }
 
 void loop() {
-  static uint32_t frame_count = 0;
-  static uint32_t last_fps_update = 0;
-  static uint32_t last_touch_check = 0;
-  static uint32_t last_lvgl_update = 0;
-  static uint32_t last_tick_update = 0;
   static uint32_t last_connection_check = 0;
+  static uint32_t last_status_icon_check = 0;
   uint32_t now = millis();
+  uint32_t wait = LOOP_MAX_SLEEP;
   
-  // Update LVGL tick counter - critical for animations and timers
-  uint32_t tick_elapsed = now - last_tick_update;
-  if (tick_elapsed > 0) {
-    lv_tick_inc(tick_elapsed);
-    last_tick_update = now;
-  }
+  logFlush();
   
-  // Handle MQTT communication in test mode
+  // Status messages and link changes from the network task, then the
+  // commands that are due go the other way
   if (!testMode) {
-    if (!mqttClient.connected()) {
-      reconnect();
+    NetEvent event;
+    while (spscPop(&netEvents, &event)) {
+      if (event.type == NET_EVENT_STATUS) applyUnitStatus(event.unitIndex, event.status, event.receivedAt);
+      else updateStatusIcons();
     }
-    mqttClient.loop();
+    commandQueueStep(now);
+    saveUnitStateStep(now);
+    wait = min(wait, commandQueueIdleTime(now));
+    if (unitStatePending) wait = min(wait, timeUntil(now, unitStatePendingSince, UNIT_STATE_SAVE_DELAY));
+    
+    // 'h' on the serial console dumps the command latency histograms
+    if (Serial.available() && Serial.read() == 'h') printLatencyHistograms();
     
-    // Check MQTT connection status periodically
+    // Report statistics periodically
     if (now - last_connection_check > CONNECTION_CHECK_INTERVAL) {
-      if (!mqttClient.connected()) {
-        Serial.println("WARNING: MQTT connection lost! Attempting to reconnect...");
-        reconnect();
-      }
+      LOG_DEBUG("Card redraws avoided: %u\n", (unsigned)cardRedrawsAvoided);
+      LOG_DEBUG("Commands coalesced: %u\n", (unsigned)commandsCoalesced);
+      LOG_DEBUG("Commands confirmed: %u, timed out: %u, superseded: %u, status held back: %u, RTT last %u ms avg %u ms\n",
+                (unsigned)commandStats.confirmed, (unsigned)commandStats.timedOut, (unsigned)commandStats.superseded,
+                (unsigned)commandStats.heldBack, (unsigned)commandStats.lastRttMs,
+                (unsigned)commandStats.avgRttMs);
+      LOG_DEBUG("Status messages for unknown units: %u\n",
+                (unsigned)unknownStatusMessages.load(std::memory_order_relaxed));
+      LOG_DEBUG("Task queues dropped: events %u, commands %u\n", (unsigned)netEvents.dropped.load(std::memory_order_relaxed),
+                (unsigned)netCommands.dropped.load(std::memory_order_relaxed));
+      // Idle share is logged at the default level, the rest is for debug builds
+      LOG_INFO("Idle: UI task %u%%, network task %u%%\n", (unsigned)uiIdle.percent.load(),
+                (unsigned)networkIdle.percent.load());
+#if LVGL_FLUSH_DMA
+      LOG_DEBUG("Flush wait time (us): %u\n", (unsigned)flushWaitMicros);
+#endif
+      LOG_DEBUG("Touch samples dropped: %u, low pressure: %u\n", (unsigned)touchRing.dropped.load(std::memory_order_relaxed),
+                (unsigned)touchFilter.rejected);
       last_connection_check = now;
     }
+    wait = min(wait, timeUntil(now, last_connection_check, CONNECTION_CHECK_INTERVAL + 1));
   }
   
-  // Check for touch events directly (for debugging)
-  if (now - last_touch_check > TOUCH_CHECK_INTERVAL && !g_processing_touch) { // Check touch, avoid recursive processing
-    // Set processing flag to prevent recursive calls
-    g_processing_touch = true;
-    
-    // Check IRQ pin directly
-    bool irq_active = (digitalRead(XPT2046_IRQ) == LOW);
-    
-    if (irq_active && ts.touched()) {
-      TS_Point p = ts.getPoint();
-      
-      // Store global touch state for LVGL callback
-      g_is_touched = true;
-      g_touch_x = p.x;
-      g_touch_y = p.y;
-      
-      // Map raw touch coordinates to screen coordinates
-      uint16_t x = map(p.x, 300, 3800, 0, TFT_WIDTH);
-      uint16_t y = map(p.y, 300, 3800, 0, TFT_HEIGHT);
-      
-      // Direct touch debug output removed
-      
-      // Let LVGL process this touch in the next timer handler call
-      // No direct calls to lv_indev_read here to prevent recursion
-    } else {
-      // Reset touch state when released
-      if (g_is_touched) {
-        g_is_touched = false;
-        // Touch release debug output removed
-        
-        // Let LVGL process the release in the next timer handler call
-        // No direct calls to lv_indev_read here to prevent recursion
-      }
-    }
-    
-    last_touch_check = now;
-    g_processing_touch = false; // Clear processing flag
+  // Refresh header icons when the WiFi/MQTT state changes
+  if (now - last_status_icon_check > STATUS_ICON_CHECK_INTERVAL) {
+    updateStatusIcons();
+    last_status_icon_check = now;
   }
+  wait = min(wait, timeUntil(now, last_status_icon_check, STATUS_ICON_CHECK_INTERVAL + 1));
+  
+#if LVGL_FLUSH_DMA
+  // Hand finished DMA buffers back to LVGL
+  poll_flush_complete();
+#endif
+  
+#if LOOP_LIGHT_SLEEP
+  // A pen edge that came while the chip was in light sleep is lost
+  if (!touchSampling && digitalRead(XPT2046_IRQ) == LOW) touchIrqHandler();
+#endif
   
-  // Handle LVGL tasks more frequently
-  if (now - last_lvgl_update > LVGL_TIMER_INTERVAL) { // Process LVGL tasks for smoother UI
-    lv_timer_handler(); // This will process any pending touch events via the callback
-    last_lvgl_update = now;
+  // New touch samples are read right away instead of at the next read
+  // timer period. The read timer only runs while a touch or the scroll
+  // it started is going on, so an idle screen has no LVGL timer due.
+  lv_timer_t *readTimer = lv_indev_get_read_timer(indev);
+  if (!spscEmpty(&touchRing)) {
+    lv_timer_resume(readTimer);
+    lv_indev_read(indev);
+  } else if (lv_indev_get_state(indev) == LV_INDEV_STATE_RELEASED && !lv_indev_get_scroll_obj(indev)) {
+    lv_timer_pause(readTimer);
   }
   
-  // Use a smaller delay to keep the UI responsive while preventing watchdog reset
-  delay(1);
+  // Runs the timers that are due and returns the time to the next one
+  wait = min(wait, lv_timer_handler());
+  
+#if LVGL_FLUSH_DMA
+  if (flushInFlight) wait = min(wait, (uint32_t)portTICK_PERIOD_MS);
+#endif
+  
+  loopWait(wait);
+}
+
+// Schedule the next connect attempt: exponential backoff with jitter so
+// a broker restart is not hit by every controller at the same moment
+static void startMqttBackoff(uint32_t now) {
+  int32_t spread = mqttBackoffMs * MQTT_RECONNECT_JITTER / 100;
+  uint32_t wait = mqttBackoffMs + random(-spread, spread + 1);
+  mqttRetryAt = now + wait;
+  mqttBackoffMs = min((uint32_t)MQTT_RECONNECT_DELAY_MAX, mqttBackoffMs * 2);
+  
+  LOG_WARN("MQTT connection failed, rc=%d try again in %u ms\n", mqttClient.state(), (unsigned)wait);
+  setMqttLinkState(MQTT_LINK_BACKOFF);
 }
 
-void reconnect() {
-  // Loop until we're reconnected
-  while (!mqttClient.connected()) {
-    Serial.print("Attempting MQTT connection...");
-    // Attempt to connect
-    if (mqttClient.connect("ESP32Client", mqttUser, mqttPassword)) {
-      Serial.println("connected");
-      // Subscribe to all AC unit status topics
+// Advance the MQTT link by one step. Never waits: the only call that can
+// take time is connect(), bounded by MQTT_SOCKET_TIMEOUT.
+void mqttLinkStep(uint32_t now) {
+  switch (mqttLinkState) {
+    case MQTT_LINK_IDLE:
+      if (!mqttClient.connected() && WiFi.status() == WL_CONNECTED) {
+        LOG_WARN("WARNING: MQTT connection lost! Attempting to reconnect...\n");
+        setMqttLinkState(MQTT_LINK_CONNECTING);
+      }
+      break;
+      
+    case MQTT_LINK_CONNECTING:
+      if (WiFi.status() != WL_CONNECTED) {
+        // Wait in idle until WiFi is back
+        setMqttLinkState(MQTT_LINK_IDLE);
+        break;
+      }
+      LOG_INFO("Attempting MQTT connection...\n");
+      if (mqttClient.connect("ESP32Client", mqttUser, mqttPassword)) {
+        LOG_INFO("MQTT connection successful!\n");
+        mqttBackoffMs = MQTT_RECONNECT_DELAY;
+        setMqttLinkState(MQTT_LINK_SUBSCRIBING);
+      } else {
+        startMqttBackoff(now);
+      }
+      break;
+      
+    case MQTT_LINK_SUBSCRIBING:
+      if (!mqttClient.connected()) {
+        startMqttBackoff(now);
+        break;
+      }
+      // subscribe() only writes the packet, the SUBACKs are not waited
+      // for, so all subscriptions go out back to back in this one step
+#if MQTT_STATUS_WILDCARD
+      mqttClient.subscribe(MQTT_STATUS_WILDCARD_TOPIC);
+      LOG_DEBUG("Subscribed to: %s\n", MQTT_STATUS_WILDCARD_TOPIC);
+#else
       for (int i = 0; i < numUnits; i++) {
-        char statusTopic[MQTT_TOPIC_MAX_LENGTH];
-        generateStatusTopic(statusTopic, acUnits[i].mqttTopic);
-        mqttClient.subscribe(statusTopic);
-        DEBUG_PRINT("Subscribed to: ");
-        DEBUG_PRINTLN(statusTopic);
+        mqttClient.subscribe(statusTopics[i]);
+        LOG_DEBUG("Subscribed to: %s\n", statusTopics[i]);
       }
+#endif
+      setMqttLinkState(MQTT_LINK_IDLE);
+      break;
       
-      // Wait for natural status updates from Home Assistant
-      // Removed: force status polling as it can cause race conditions
-      delay(1000); // Wait a bit for subscriptions to be processed
-    } else {
-      Serial.print("failed, rc=");
-      Serial.print(mqttClient.state());
-      Serial.println(" try again in 5 seconds");
-      // Wait 5 seconds before retrying
-      delay(5000);
-    }
+    case MQTT_LINK_BACKOFF:
+      if ((int32_t)(now - mqttRetryAt) >= 0) {
+        setMqttLinkState(MQTT_LINK_CONNECTING);
+      }
+      break;
   }
 }
 
+// Runs in the network task for every status message: parse it and hand
+// the fields to the UI task. It only logs through the ring buffer.
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-  DEBUG_PRINTLN("=== MQTT CALLBACK START ===");
-  DEBUG_PRINT("Topic: ");
-  DEBUG_PRINTLN(topic);
+  LOG_DEBUG("MQTT status %s: %.*s\n", topic, (int)length, (const char *)payload);
+  
+  // Find which unit this status update is for
+  int unitIndex = findUnitByStatusTopic(topic);
+  if (unitIndex < 0) {
+    unknownStatusMessages.fetch_add(1, std::memory_order_relaxed);
+    LOG_DEBUG("Topic did not match any unit: %s\n", topic);
+    return;
+  }
   
-  // Convert payload to string
-  char message[length + 1];
-  for (int i = 0; i < length; i++) {
-    message[i] = (char)payload[i];
+  // Parse the status message in place, no copy of the payload
+  NetEvent event;
+  event.type = NET_EVENT_STATUS;
+  event.unitIndex = unitIndex;
+  event.receivedAt = millis();
+  if (!parseStatusPayload(payload, length, &event.status)) {
+    LOG_WARN("JSON parsing failed: invalid status payload for %s\n", acUnits[unitIndex].name);
+    return;
+  }
+  if (!spscPush(&netEvents, event)) {
+    LOG_WARN("Status for %s dropped, UI task is behind\n", acUnits[unitIndex].name);
   }
-  message[length] = '\0';
+  wakeUiTask();
+}
+
+// Update unit data from a parsed status, in the UI task. Fields with a
+// pending command only take the status value once it confirms the command.
+void applyUnitStatus(int unitIndex, const ACStatus &status, uint32_t now) {
+  ACUnit *unit = &acUnits[unitIndex];
   
-  DEBUG_PRINT("Payload: ");
-  DEBUG_PRINTLN(message);
+  if (status.present & STATUS_HAS_CURRENT_TEMP) {
+    if (status.currentTemp != unit->currentTemp) {
+      unit->currentTemp = status.currentTemp;
+      publishUnitFields(unitIndex, AC_FIELD_MASK_CURRENT_TEMP);
+    }
+    LOG_DEBUG("  - Current temp: %.2f\n", unit->currentTemp);
+  }
   
-  // Parse JSON status message
-  StaticJsonDocument<200> doc;
-  DeserializationError error = deserializeJson(doc, message);
+  if ((status.present & STATUS_HAS_POWER) && acceptStatusField(unitIndex, AC_COMMAND_POWER, status.isOn, now)) {
+    bool oldState = unit->isOn;
+    unit->isOn = status.isOn;
+    if (unit->isOn != oldState) {
+      publishUnitFields(unitIndex, AC_FIELD_MASK_POWER);
+    }
+    LOG_DEBUG("  - Power: %s -> %s\n", oldState ? "on" : "off", unit->isOn ? "on" : "off");
+  }
   
-  if (error) {
-    Serial.print("JSON parsing failed: ");
-    Serial.println(error.c_str());
-    return;
+  if ((status.present & STATUS_HAS_MODE) && acceptStatusField(unitIndex, AC_COMMAND_MODE, status.mode, now)) {
+    if (status.mode != unit->mode) {
+      unit->mode = status.mode;
+      publishUnitFields(unitIndex, AC_FIELD_MASK_MODE);
+    }
+    LOG_DEBUG("  - HVAC mode index %u\n", unit->mode);
   }
   
-  // Find which unit this status update is for
-  bool topicMatched = false;
-  for (int i = 0; i < numUnits; i++) {
-    char statusTopic[MQTT_TOPIC_MAX_LENGTH];
-    generateStatusTopic(statusTopic, acUnits[i].mqttTopic);
-    
-    if (strcmp(topic, statusTopic) == 0) {
-      topicMatched = true;
-      Serial.print("Topic matched for unit ");
-      Serial.print(i);
-      Serial.print(" (");
-      Serial.print(acUnits[i].name);
-      Serial.println(")");
-      
-      // Update unit data from JSON
-      ACUnit *unit = &acUnits[i];
-      
-      Serial.print("BEFORE UPDATE - Unit ");
-      Serial.print(unit->name);
-      Serial.print(": Power=");
-      Serial.print(unit->isOn ? "on" : "off");
-      Serial.print(", Mode=");
-      Serial.println(unit->mode);
-      
-      if (doc.containsKey("current_temperature")) {
-        unit->currentTemp = doc["current_temperature"];
-        Serial.print("  - Current temp: ");
-        Serial.println(unit->currentTemp);
-      }
-      
-      if (doc.containsKey("power")) {
-        const char* power = doc["power"];
-        bool oldState = unit->isOn;
-        // Handle both "on"/"off" and "ON"/"OFF" cases
-        unit->isOn = (strcasecmp(power, "on") == 0);
-        Serial.print("  - Power: ");
-        Serial.print(power);
-        Serial.print(" (was: ");
-        Serial.print(oldState ? "on" : "off");
-        Serial.print(", now: ");
-        Serial.print(unit->isOn ? "on" : "off");
-        Serial.println(")");
-      }
-      
-      if (doc.containsKey("hvac_mode")) {
-        const char* mode = doc["hvac_mode"];
-        DEBUG_PRINT("  - HVAC mode: ");
-        DEBUG_PRINT(mode);
-        // Convert HVAC mode string to index using helper function
-        unit->mode = getModeIndexFromMQTT(mode);
-        DEBUG_PRINT(" -> index ");
-        DEBUG_PRINTLN(unit->mode);
-      }
-      
-      if (doc.containsKey("fan_mode")) {
-        const char* fan = doc["fan_mode"];
-        DEBUG_PRINT("  - Fan mode: ");
-        DEBUG_PRINT(fan);
-        // Convert fan mode string to index using helper function
-        unit->fanSpeed = getFanIndexFromMQTT(fan);
-        DEBUG_PRINT(" -> index ");
-        DEBUG_PRINTLN(unit->fanSpeed);
-      }
-      
-      if (doc.containsKey("swing_mode")) {
-        const char* swing = doc["swing_mode"];
-        DEBUG_PRINT("  - Swing mode: ");
-        DEBUG_PRINT(swing);
-        // Convert swing mode string to index using helper function
-        unit->swingMode = getSwingIndexFromMQTT(swing);
-        DEBUG_PRINT(" -> index ");
-        DEBUG_PRINTLN(unit->swingMode);
-      }
-      
-      if (doc.containsKey("setpoint")) {
-        unit->targetTemp = doc["setpoint"];
-        Serial.print("  - Setpoint: ");
-        Serial.println(unit->targetTemp);
-      }
-      
-      Serial.print("AFTER UPDATE - Unit ");
-      Serial.print(unit->name);
-      Serial.print(": Temp=");
-      Serial.print(unit->currentTemp);
-      Serial.print("°C, Power=");
-      Serial.print(unit->isOn ? "on" : "off");
-      Serial.print(", Mode=");
-      Serial.print(unit->mode);
-      Serial.print(", Fan=");
-      Serial.print(unit->fanSpeed);
-      Serial.print(", Swing=");
-      Serial.println(unit->swingMode);
-      
-      Serial.println("=== MQTT CALLBACK END ===");
-      break;
+  if ((status.present & STATUS_HAS_FAN) && acceptStatusField(unitIndex, AC_COMMAND_FAN, status.fanSpeed, now)) {
+    if (status.fanSpeed != unit->fanSpeed) {
+      unit->fanSpeed = status.fanSpeed;
+      publishUnitFields(unitIndex, AC_FIELD_MASK_FAN);
+    }
+    LOG_DEBUG("  - Fan mode index %u\n", unit->fanSpeed);
+  }
+  
+  if ((status.present & STATUS_HAS_SWING) && acceptStatusField(unitIndex, AC_COMMAND_SWING, status.swingMode, now)) {
+    if (status.swingMode != unit->swingMode) {
+      unit->swingMode = status.swingMode;
+      publishUnitFields(unitIndex, AC_FIELD_MASK_SWING);
     }
+    LOG_DEBUG("  - Swing mode index %u\n", unit->swingMode);
   }
   
-  if (!topicMatched) {
-    Serial.println("Topic did not match any unit");
+  if ((status.present & STATUS_HAS_SETPOINT) &&
+      acceptStatusField(unitIndex, AC_COMMAND_TEMPERATURE, (int16_t)lroundf(status.setpoint * 10), now)) {
+    if (status.setpoint != unit->targetTemp) {
+      unit->targetTemp = status.setpoint;
+      publishUnitFields(unitIndex, AC_FIELD_MASK_TARGET_TEMP);
+    }
+    LOG_DEBUG("  - Setpoint: %.2f\n", unit->targetTemp);
   }
+  
+  LOG_DEBUG("Unit %s: Temp=%.2f°C, Power=%s, Mode=%u, Fan=%u, Swing=%u\n", unit->name, unit->currentTemp,
+            unit->isOn ? "on" : "off", unit->mode, unit->fanSpeed, unit->swingMode);
 }
 
 // Update data for a specific unit
@@ -653,18 +1168,18 @@ void updateUnitData(int unitIndex) {
       // Keep temperature in reasonable range
       if (unit->currentTemp < 18.0) unit->currentTemp = 18.0;
       if (unit->currentTemp > 28.0) unit->currentTemp = 28.0;
+      publishUnitFields(unitIndex, AC_FIELD_MASK_CURRENT_TEMP);
       
       lastTempUpdate = now;
     }
     // No need to update other values in test mode as they're
     // controlled by user actions
   } 
-  else if (mqttClient.connected()) {
+  else if (mqttConnected) {
     // In normal mode, data is updated via MQTT callbacks
     // No need to actively poll - data updates happen via callbacks
   } else {
-    Serial.print("WARNING: MQTT not connected - skipping data update for unit ");
-    Serial.println(unitIndex);
+    LOG_DEBUG("WARNING: MQTT not connected - skipping data update for unit %d\n", unitIndex);
   }
 }
 
@@ -675,29 +1190,316 @@ void updateAllUnits() {
   }
 }
 
+// Subject value for a unit field; temperatures are stored in tenths of a degree
+static int32_t getUnitSubjectValue(const ACUnit *unit, int field) {
+  switch (field) {
+    case AC_FIELD_CURRENT_TEMP:
+      if (isnan(unit->currentTemp)) return INT32_MIN; // AC_TEMP_UNKNOWN
+      return (int32_t)lroundf(unit->currentTemp * 10);
+    case AC_FIELD_POWER: return unit->isOn ? 1 : 0;
+    case AC_FIELD_MODE: return unit->mode;
+    case AC_FIELD_FAN: return unit->fanSpeed;
+    case AC_FIELD_SWING: return unit->swingMode;
+    case AC_FIELD_TARGET_TEMP: return (int32_t)lroundf(unit->targetTemp * 10);
+    default: return 0;
+  }
+}
+
+// Initialize the LVGL subjects of all units from their current values
+void initUnitSubjects() {
+  for (int i = 0; i < numUnits; i++) {
+    for (int f = 0; f < AC_FIELD_COUNT; f++) {
+      lv_subject_init_int(&acUnits[i].subjects[f], getUnitSubjectValue(&acUnits[i], f));
+    }
+  }
+}
+
+// Publish changed fields of a unit to their subjects, which updates every bound widget
+void publishUnitFields(int unitIndex, uint8_t fields) {
+  if (!VALIDATE_UNIT_INDEX(unitIndex)) return;
+  
+  ACUnit *unit = &acUnits[unitIndex];
+  for (int f = 0; f < AC_FIELD_COUNT; f++) {
+    if (fields & (1 << f)) {
+      lv_subject_set_int(&unit->subjects[f], getUnitSubjectValue(unit, f));
+    }
+  }
+  
+  // Schedule a snapshot, the dummy data of test mode is not saved
+  if (!testMode && !unitStatePending) {
+    unitStatePending = true;
+    unitStatePendingSince = millis();
+  }
+}
+
+// Topic type per AC_COMMAND_*
+static const char *const commandTopicTypes[AC_COMMAND_COUNT] = {
+  MQTT_COMMAND_POWER, MQTT_COMMAND_MODE, MQTT_COMMAND_FAN_MODE, MQTT_COMMAND_SWING_MODE, MQTT_COMMAND_TEMPERATURE
+};
+
+void queueUnitCommand(int unitIndex, uint8_t command, int16_t value, uint32_t delayMs) {
+  QueuedCommand *cmd = &commandQueue[unitIndex][command];
+  bool wasIdle = !unitHasQueuedCommands(unitIndex);
+  if (cmd->queued) commandsCoalesced++;
+  cmd->queued = true;
+  cmd->value = value;
+  cmd->dueAt = millis() + delayMs;
+  if (wasIdle) showUnitCommandProgress(unitIndex);
+}
+
+bool unitHasQueuedCommands(int unitIndex) {
+  for (uint8_t c = 0; c < AC_COMMAND_COUNT; c++) {
+    if (commandQueue[unitIndex][c].queued) return true;
+  }
+  return false;
+}
+
+static void publishUnitCommand(int unitIndex, uint8_t command, int16_t value, uint16_t seq) {
+  char topic[MQTT_TOPIC_MAX_LENGTH];
+  char payload[12];
+  const char *message = payload;
+  generateCommandTopic(topic, acUnits[unitIndex].mqttTopic, commandTopicTypes[command]);
+  
+  switch (command) {
+    case AC_COMMAND_POWER: message = value ? MQTT_POWER_ON : MQTT_POWER_OFF; break;
+    case AC_COMMAND_MODE: message = getMQTTModeString(value); break;
+    case AC_COMMAND_FAN: message = getMQTTFanString(value); break;
+    case AC_COMMAND_SWING: message = getMQTTSwingString(value); break;
+    case AC_COMMAND_TEMPERATURE:
+      snprintf(payload, sizeof(payload), "%.2f", value / 10.0); // Same format as String(float)
+      break;
+  }
+  mqttClient.publish(topic, message);
+  LOG_DEBUG("MQTT: Published #%u %s %s\n", seq, topic, message);
+}
+
+// Publish the commands the UI task handed over
+static void publishNetCommands() {
+  NetCommand cmd;
+  while (spscPop(&netCommands, &cmd)) {
+    publishUnitCommand(cmd.unitIndex, cmd.command, cmd.value, cmd.seq);
+  }
+}
+
+// Time until mqttLinkStep() has work without any socket data
+static uint32_t networkIdleTime(uint32_t now) {
+  switch (mqttLinkState) {
+    case MQTT_LINK_CONNECTING:
+    case MQTT_LINK_SUBSCRIBING:
+      return 0;
+    case MQTT_LINK_BACKOFF:
+      return (int32_t)(mqttRetryAt - now) <= 0 ? 0 : min((uint32_t)NETWORK_TASK_MAX_WAIT, mqttRetryAt - now);
+    default:
+      // WiFi state and the keepalive are polled
+      return NETWORK_TASK_MAX_WAIT;
+  }
+}
+
+// Block until the MQTT socket is readable, the UI task hands over
+// commands, or `ms` pass
+static void networkWait(uint32_t ms) {
+  uint32_t start = micros();
+  fd_set readable;
+  FD_ZERO(&readable);
+  FD_SET(networkWakeFd, &readable);
+  int maxFd = networkWakeFd;
+  int socketFd = mqttConnected ? wifiClient.fd() : -1;
+  if (socketFd >= 0) {
+    FD_SET(socketFd, &readable);
+    maxFd = max(maxFd, socketFd);
+  }
+  struct timeval timeout;
+  timeout.tv_sec = ms / 1000;
+  timeout.tv_usec = (ms % 1000) * 1000;
+  int ready = select(maxFd + 1, &readable, NULL, NULL, &timeout);
+  if (ready < 0) {
+    vTaskDelay(pdMS_TO_TICKS(ms)); // Socket closed under us, mqttClient notices next step
+  } else if (ready > 0 && FD_ISSET(networkWakeFd, &readable)) {
+    uint64_t count;
+    read(networkWakeFd, &count, sizeof(count));
+  }
+  idleTimeAdd(&networkIdle, start, micros());
+}
+
+// Network task, pinned to NETWORK_TASK_CORE. Owns WiFi and mqttClient:
+// boot stages, link state machine, incoming messages (mqttCallback runs
+// from mqttClient.loop()) and publishing. A slow connect() only stalls
+// this task, the UI keeps running on the other core.
+static void networkTask(void *arg) {
+  for (;;) {
+    uint32_t now = millis();
+    bootStep(now);
+    mqttLinkStep(now);
+    mqttClient.loop();
+    publishNetCommands();
+    // Held back commands can go once the link is up
+    bool connected = mqttClient.connected();
+    if (connected != mqttConnected) {
+      mqttConnected = connected;
+      wakeUiTask();
+    }
+    // PubSubClient handles one packet per loop(), the next one may
+    // already be in the client's buffer where select() does not see it
+    if (mqttConnected && wifiClient.available() > 0) continue;
+    networkWait(networkIdleTime(millis()));
+  }
+}
+
+// Called by applyUnitStatus() in loop() for each command field in a
+// status message; `now` is when the network task received it. Returns
+// false when the value must not be applied: a command for the field is
+// still queued, or is in flight and the status shows another value or
+// was received before the command was handed over. A later status that
+// matches the in-flight value confirms it.
+bool acceptStatusField(int unitIndex, uint8_t command, int16_t value, uint32_t now) {
+  QueuedCommand *cmd = &commandQueue[unitIndex][command];
+  if (cmd->inFlight) {
+    int32_t age = (int32_t)(now - cmd->sentAt);
+    if (age < 0 || (value != cmd->sentValue && age < COMMAND_CONFIRM_TIMEOUT)) {
+      commandStats.heldBack++;
+      return false;
+    }
+    cmd->inFlight = false;
+    bulkCommandDone(cmd, value == cmd->sentValue, now);
+    if (value == cmd->sentValue) {
+      uint32_t rtt = age;
+      commandStats.confirmed++;
+      commandStats.lastRttMs = rtt;
+      commandStats.avgRttMs = commandStats.confirmed == 1 ? rtt : (commandStats.avgRttMs * 7 + rtt) / 8;
+      latencyRecord(&unitLatency[unitIndex], rtt);
+      LOG_DEBUG("Command #%u confirmed in %u ms\n", cmd->seq, (unsigned)rtt);
+    } else {
+      commandStats.timedOut++;
+    }
+  }
+  if (cmd->queued) {
+    commandStats.heldBack++;
+    return false;
+  }
+  return true;
+}
+
+// Print the latency histograms over serial, one row per unit plus the
+// total. Columns are the bucket limits in ms. Goes through the log ring
+// like everything else printed from loop(), one whole row per logWrite()
+// so a full ring drops rows rather than cutting them.
+void printLatencyHistograms() {
+  LatencyHistogram total = {};
+  char row[LOG_LINE_MAX];
+  int length = snprintf(row, sizeof(row), "unit,samples,avg_ms,max_ms");
+  for (uint8_t b = 0; b < LATENCY_BUCKETS && length < (int)sizeof(row); b++) {
+    const char *format = b < LATENCY_BUCKETS - 1 ? ",<%u" : ",>=%u";
+    length += snprintf(row + length, sizeof(row) - length, format,
+                       (unsigned)latencyBucketLimit(b < LATENCY_BUCKETS - 1 ? b : b - 1));
+  }
+  logWrite("%s\n", row);
+  for (int i = 0; i <= numUnits; i++) {
+    const LatencyHistogram *h = i < numUnits ? &unitLatency[i] : &total;
+    if (i < numUnits) latencyMerge(&total, h);
+    length = snprintf(row, sizeof(row), "%s,%u,%u,%u", i < numUnits ? acUnits[i].mqttTopic : "all",
+                      (unsigned)h->samples, (unsigned)(h->samples ? h->sumMs / h->samples : 0), (unsigned)h->maxMs);
+    for (uint8_t b = 0; b < LATENCY_BUCKETS && length < (int)sizeof(row); b++) {
+      length += snprintf(row + length, sizeof(row) - length, ",%u", h->counts[b]);
+    }
+    logWrite("%s\n", row);
+  }
+}
+
+// Hand the commands that are due to the network task, as far as the rate limit allows.
+// Commands wait while MQTT is down and go out after the reconnect, power
+// first so a unit is on before its mode changes.
+void commandQueueStep(uint32_t now) {
+  uint32_t earned = (now - commandTokenAt) / COMMAND_RATE_INTERVAL;
+  if (earned > 0) {
+    commandTokens = min((uint32_t)COMMAND_RATE_BURST, commandTokens + earned);
+    commandTokenAt = commandTokens == COMMAND_RATE_BURST ? now : commandTokenAt + earned * COMMAND_RATE_INTERVAL;
+  }
+  // Commands without a confirmation give up their hold on the field,
+  // the next status message is applied as is
+  for (int i = 0; i < numUnits; i++) {
+    for (uint8_t c = 0; c < AC_COMMAND_COUNT; c++) {
+      QueuedCommand *cmd = &commandQueue[i][c];
+      if (cmd->inFlight && (int32_t)(now - cmd->sentAt) >= COMMAND_CONFIRM_TIMEOUT) {
+        cmd->inFlight = false;
+        bulkCommandDone(cmd, false, now);
+        commandStats.timedOut++;
+        LOG_WARN("Command #%u for %s not confirmed within %u ms\n", cmd->seq, acUnits[i].name,
+                 (unsigned)COMMAND_CONFIRM_TIMEOUT);
+      }
+    }
+  }
+  
+  if (!mqttConnected) return;
+  
+  bool handedOver = false;
+  for (int i = 0; i < numUnits && commandTokens > 0; i++) {
+    bool published = false;
+    for (uint8_t c = 0; c < AC_COMMAND_COUNT && commandTokens > 0; c++) {
+      QueuedCommand *cmd = &commandQueue[i][c];
+      if (!cmd->queued || (int32_t)(now - cmd->dueAt) < 0) continue;
+      
+      // The network task publishes it; with its queue full the command
+      // simply stays queued for the next step
+      NetCommand out = {(int8_t)i, c, cmd->value, (uint16_t)(commandSeq + 1)};
+      if (!spscPush(&netCommands, out)) break;
+      handedOver = true;
+      
+      // A command still waiting for its confirmation is settled here, the
+      // newer value takes its place and no status can confirm it anymore
+      if (cmd->inFlight) {
+        commandStats.superseded++;
+        LOG_DEBUG("Command #%u for %s superseded by #%u\n", cmd->seq, acUnits[i].name, out.seq);
+      }
+      cmd->queued = false;
+      cmd->inFlight = true;
+      cmd->sentValue = cmd->value;
+      cmd->sentAt = now;
+      cmd->seq = ++commandSeq;
+      commandTokens--;
+      published = true;
+      
+      // A value that replaces an in-flight batch one stays in the batch
+      cmd->sentBulk = cmd->sentBulk || cmd->bulk;
+      cmd->bulk = false;
+    }
+    if (published && !unitHasQueuedCommands(i)) showUnitCommandProgress(i);
+  }
+  if (handedOver) wakeNetworkTask();
+}
+
+// Milliseconds until commandQueueStep() has work again: a queued command
+// getting due or earning a token, or an in-flight one timing out. Queued
+// commands wait for the link without a deadline, the link event wakes
+// the UI task when it comes up.
+uint32_t commandQueueIdleTime(uint32_t now) {
+  uint32_t wait = LOOP_MAX_SLEEP;
+  uint32_t tokenWait = commandTokens > 0 ? 0 : timeUntil(now, commandTokenAt, COMMAND_RATE_INTERVAL);
+  for (int i = 0; i < numUnits; i++) {
+    for (uint8_t c = 0; c < AC_COMMAND_COUNT; c++) {
+      const QueuedCommand *cmd = &commandQueue[i][c];
+      if (cmd->inFlight) wait = min(wait, timeUntil(now, cmd->sentAt, COMMAND_CONFIRM_TIMEOUT));
+      if (cmd->queued && mqttConnected) {
+        uint32_t due = (int32_t)(now - cmd->dueAt) >= 0 ? 0 : cmd->dueAt - now;
+        wait = min(wait, max(due, tokenWait));
+      }
+    }
+  }
+  return wait;
+}
+
 // Set AC power state
 void setACPower(int unitIndex, bool state) {
   if (!VALIDATE_UNIT_INDEX(unitIndex)) return;
   
   ACUnit *unit = &acUnits[unitIndex];
+  unit->isOn = state;
+  publishUnitFields(unitIndex, AC_FIELD_MASK_POWER);
   
-  if (testMode) {
-    // In test mode, just update local state
-    unit->isOn = state;
-    DEBUG_PRINT("TEST MODE: Setting power for ");
-    DEBUG_PRINT(unit->name);
-    DEBUG_PRINT(" to ");
-    DEBUG_PRINTLN(state ? "on" : "off");
-  } else if (mqttClient.connected()) {
-    char topic[MQTT_TOPIC_MAX_LENGTH];
-    generateCommandTopic(topic, unit->mqttTopic, MQTT_COMMAND_POWER);
-    mqttClient.publish(topic, state ? MQTT_POWER_ON : MQTT_POWER_OFF);
-    unit->isOn = state;
-    DEBUG_PRINT("MQTT: Setting power for ");
-    DEBUG_PRINT(unit->name);
-    DEBUG_PRINT(" to ");
-    DEBUG_PRINTLN(state ? "on" : "off");
+  // In test mode, just update local state
+  if (!testMode) {
+    queueUnitCommand(unitIndex, AC_COMMAND_POWER, state ? 1 : 0, 0);
   }
+  LOG_DEBUG("%s: Setting power for %s to %s\n", testMode ? "TEST MODE" : "MQTT", unit->name, state ? "on" : "off");
 }
 
 // Set AC mode
@@ -705,25 +1507,14 @@ void setACMode(int unitIndex, uint8_t mode) {
   if (!VALIDATE_UNIT_INDEX(unitIndex) || !VALIDATE_MODE(mode)) return;
   
   ACUnit *unit = &acUnits[unitIndex];
+  unit->mode = mode;
+  publishUnitFields(unitIndex, AC_FIELD_MASK_MODE);
   
-  if (testMode) {
-    // In test mode, just update local state
-    unit->mode = mode;
-    DEBUG_PRINT("TEST MODE: Setting mode for ");
-    DEBUG_PRINT(unit->name);
-    DEBUG_PRINT(" to ");
-    DEBUG_PRINTLN(modeNames[mode]);
-  } else if (mqttClient.connected()) {
-    char topic[MQTT_TOPIC_MAX_LENGTH];
-    generateCommandTopic(topic, unit->mqttTopic, MQTT_COMMAND_MODE);
-    const char* modeStr = getMQTTModeString(mode);
-    mqttClient.publish(topic, modeStr);
-    unit->mode = mode;
-    DEBUG_PRINT("MQTT: Setting mode for ");
-    DEBUG_PRINT(unit->name);
-    DEBUG_PRINT(" to ");
-    DEBUG_PRINTLN(modeStr);
+  // In test mode, just update local state
+  if (!testMode) {
+    queueUnitCommand(unitIndex, AC_COMMAND_MODE, mode, 0);
   }
+  LOG_DEBUG("%s: Setting mode for %s to %s\n", testMode ? "TEST MODE" : "MQTT", unit->name, modeNames[mode]);
 }
 
 // Set AC fan speed
@@ -731,25 +1522,14 @@ void setACFanSpeed(int unitIndex, uint8_t speed) {
   if (!VALIDATE_UNIT_INDEX(unitIndex) || !VALIDATE_FAN_SPEED(speed)) return;
   
   ACUnit *unit = &acUnits[unitIndex];
+  unit->fanSpeed = speed;
+  publishUnitFields(unitIndex, AC_FIELD_MASK_FAN);
   
-  if (testMode) {
-    // In test mode, just update local state
-    unit->fanSpeed = speed;
-    DEBUG_PRINT("TEST MODE: Setting fan speed for ");
-    DEBUG_PRINT(unit->name);
-    DEBUG_PRINT(" to ");
-    DEBUG_PRINTLN(fanNames[speed]);
-  } else if (mqttClient.connected()) {
-    char topic[MQTT_TOPIC_MAX_LENGTH];
-    generateCommandTopic(topic, unit->mqttTopic, MQTT_COMMAND_FAN_MODE);
-    const char* fanStr = getMQTTFanString(speed);
-    mqttClient.publish(topic, fanStr);
-    unit->fanSpeed = speed;
-    DEBUG_PRINT("MQTT: Setting fan speed for ");
-    DEBUG_PRINT(unit->name);
-    DEBUG_PRINT(" to ");
-    DEBUG_PRINTLN(fanStr);
+  // In test mode, just update local state
+  if (!testMode) {
+    queueUnitCommand(unitIndex, AC_COMMAND_FAN, speed, 0);
   }
+  LOG_DEBUG("%s: Setting fan speed for %s to %s\n", testMode ? "TEST MODE" : "MQTT", unit->name, fanNames[speed]);
 }
 
 // Set AC swing mode
@@ -757,28 +1537,18 @@ void setACSwing(int unitIndex, uint8_t mode) {
   if (!VALIDATE_UNIT_INDEX(unitIndex) || !VALIDATE_SWING_MODE(mode)) return;
   
   ACUnit *unit = &acUnits[unitIndex];
+  unit->swingMode = mode;
+  publishUnitFields(unitIndex, AC_FIELD_MASK_SWING);
   
-  if (testMode) {
-    // In test mode, just update local state
-    unit->swingMode = mode;
-    DEBUG_PRINT("TEST MODE: Setting swing for ");
-    DEBUG_PRINT(unit->name);
-    DEBUG_PRINT(" to ");
-    DEBUG_PRINTLN(swingNames[mode]);
-  } else if (mqttClient.connected()) {
-    char topic[MQTT_TOPIC_MAX_LENGTH];
-    generateCommandTopic(topic, unit->mqttTopic, MQTT_COMMAND_SWING_MODE);
-    const char* swingStr = getMQTTSwingString(mode);
-    mqttClient.publish(topic, swingStr);
-    unit->swingMode = mode;
-    DEBUG_PRINT("MQTT: Setting swing mode for ");
-    DEBUG_PRINT(unit->name);
-    DEBUG_PRINT(" to ");
-    DEBUG_PRINTLN(swingStr);
-  }
-}
-
-// Set AC target temperature
+  // In test mode, just update local state
+  if (!testMode) {
+    queueUnitCommand(unitIndex, AC_COMMAND_SWING, mode, 0);
+  }
+  LOG_DEBUG("%s: Setting swing mode for %s to %s\n", testMode ? "TEST MODE" : "MQTT", unit->name, swingNames[mode]);
+}
+
+// Set AC target temperature. The screen follows right away, the command
+// waits COMMAND_COALESCE_WINDOW for further +/- presses.
 void setACTemperature(int unitIndex, float temp) {
   if (!VALIDATE_UNIT_INDEX(unitIndex)) return;
   
@@ -788,33 +1558,35 @@ void setACTemperature(int unitIndex, float temp) {
   if (temp < MQTT_TEMP_MIN) temp = MQTT_TEMP_MIN;
   if (temp > MQTT_TEMP_MAX) temp = MQTT_TEMP_MAX;
   
-  if (testMode) {
-    // In test mode, just update local state
-    unit->targetTemp = temp;
-    DEBUG_PRINT("TEST MODE: Setting temperature for ");
-    DEBUG_PRINT(unit->name);
-    DEBUG_PRINT(" to ");
-    DEBUG_PRINT(temp);
-    DEBUG_PRINTLN("°C");
-  } else if (mqttClient.connected()) {
-    char topic[MQTT_TOPIC_MAX_LENGTH];
-    generateCommandTopic(topic, unit->mqttTopic, MQTT_COMMAND_TEMPERATURE);
-    mqttClient.publish(topic, String(temp).c_str());
-    unit->targetTemp = temp;  // Store actual temperature value
-    DEBUG_PRINT("MQTT: Setting temperature for ");
-    DEBUG_PRINT(unit->name);
-    DEBUG_PRINT(" to ");
-    DEBUG_PRINT(temp);
-    DEBUG_PRINTLN("°C");
+  unit->targetTemp = temp;  // Store actual temperature value
+  publishUnitFields(unitIndex, AC_FIELD_MASK_TARGET_TEMP);
+  
+  // In test mode, just update local state
+  if (!testMode) {
+    queueUnitCommand(unitIndex, AC_COMMAND_TEMPERATURE, (int16_t)lroundf(temp * 10), COMMAND_COALESCE_WINDOW);
   }
+  LOG_DEBUG("%s: Setting temperature for %s to %.1f°C\n", testMode ? "TEST MODE" : "MQTT", unit->name, temp);
 }
 
-// Turn off all AC units
-void turnOffAllACUnits() {
-  Serial.println("Turning off all AC units via MQTT");
+// Switch all units on or off. The commands go through the queue at the
+// publish rate limit, so the UI stays responsive and the cards show which
+// units are still waiting.
+void setAllACPower(bool state) {
+  LOG_DEBUG("Turning %s all AC units\n", state ? "on" : "off");
+  bulkRemaining = 0;
+  bulkTimedOut = 0;
+  bulkStartedAt = millis();
   for (int i = 0; i < numUnits; i++) {
-    setACPower(i, false);
-    Serial.print("Turning off unit: ");
-    Serial.println(acUnits[i].name);
+    commandQueue[i][AC_COMMAND_POWER].sentBulk = false; // A previous batch still in flight is dropped
+    setACPower(i, state);
+    if (!testMode) {
+      commandQueue[i][AC_COMMAND_POWER].bulk = true;
+      bulkRemaining++;
+    }
   }
 }
+
+// Turn off all AC units
+void turnOffAllACUnits() {
+  setAllACPower(false);
+}
@@ -16,9 +16,13 @@
 #define TFT_HEIGHT 320
 #define TFT_ROTATION 0  // Portrait mode
 
-// Touch calibration values
+// Touch calibration. Until the calibration screen has been used the raw
+// range TOUCH_RAW_MIN..TOUCH_RAW_MAX is mapped straight onto both axes.
 #define TOUCH_RAW_MIN 300
 #define TOUCH_RAW_MAX 3800
+#define TOUCH_CAL_TOLERANCE 8        // Largest error in px on the check target before a calibration is saved
+#define TOUCH_CAL_NAMESPACE "touchcal"
+#define TOUCH_CAL_KEY "matrix"
 
 // SPI configuration
 #define TOUCH_SPI_INSTANCE HSPI
@@ -26,16 +30,60 @@
 // Serial configuration
 #define SERIAL_BAUD_RATE 115200
 
-// LVGL buffer configuration
-#define LVGL_BUFFER_SIZE (TFT_WIDTH * 3)  // Buffer size for display
+// Serial logging, see src/serial_log.h
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO   // LOG_LEVEL_DEBUG adds a line per status message and command
+#endif
+#define LOG_BUFFER_SIZE 2048       // Ring buffer for log output, power of two
+#define LOG_LINE_MAX 192           // Longer messages are cut off
+
+// LVGL buffer strategies
+#define LVGL_BUFFER_LINES_PARTIAL 0   // Two buffers of LVGL_BUFFER_LINES display lines
+#define LVGL_BUFFER_TENTH_SCREEN 1    // Two buffers of 1/10 screen
+#define LVGL_BUFFER_FULL_FRAME 2      // One full frame buffer in PSRAM, falls back to 1/10 screen
 
-// LVGL timing configuration
-#define LVGL_TIMER_INTERVAL 5    // LVGL handler interval in ms
-#define LVGL_TICK_INTERVAL 1     // Tick increment interval in ms
-#define TOUCH_CHECK_INTERVAL 10  // Touch check interval in ms
+// LVGL buffer configuration
+#define LVGL_BUFFER_STRATEGY LVGL_BUFFER_LINES_PARTIAL
+#define LVGL_BUFFER_LINES 3               // Lines per buffer for LVGL_BUFFER_LINES_PARTIAL
+#define LVGL_BUFFER_PIXEL_SIZE 2          // Bytes per pixel (RGB565)
+#define LVGL_FLUSH_DMA 1                  // 1 = asynchronous DMA flush, 0 = blocking pushColors
+#define LVGL_BUFFER_BENCHMARK 0           // 1 = benchmark candidate buffer sizes at boot
+
+#if LVGL_BUFFER_STRATEGY == LVGL_BUFFER_LINES_PARTIAL
+#define LVGL_BUFFER_SIZE (TFT_WIDTH * LVGL_BUFFER_LINES)  // Buffer size for display in pixels
+#else
+#define LVGL_BUFFER_SIZE (TFT_WIDTH * TFT_HEIGHT / 10)    // Buffer size for display in pixels
+#endif
+
+// Main loop scheduling. loop() runs lv_timer_handler() and then sleeps
+// until the next LVGL timer, its own next deadline, or a wake-up from the
+// touch sampler or the network task, whichever comes first.
+#define LOOP_MAX_SLEEP 100       // Longest single wait of loop() in ms, bounds log and serial latency
+#define LOOP_LIGHT_SLEEP 0       // 1 = automatic light sleep and CPU clock scaling while all tasks wait
+
+// Touch acquisition, see src/touch_ring.h
+#define TOUCH_SAMPLE_RATE 200    // Touch samples per second while the pen is down, at most 333
+#define TOUCH_RING_SIZE 32       // Samples buffered between the sampler and LVGL, power of two
+
+// Touch filter, see src/touch_filter.h
+#define TOUCH_PRESSURE_MIN 600   // Samples with less pressure are dropped (the library's own threshold is 400)
+#define TOUCH_OVERSAMPLE 1       // Raw samples averaged into one point, 1 disables the stage; averaging before the median smears spikes and doubles the drag lag
+#define TOUCH_MEDIAN_SIZE 3      // Median window in points, 1 to 7, 1 disables the stage
+#define TOUCH_IIR_ALPHA 192      // IIR weight of a new point out of 256, 256 disables the stage; lower is smoother but trails a drag further
+#define TOUCH_TRACE 0            // 1: log every raw sample as "touch <ms> <x> <y> <z>", for host/touch_filter_benchmark
+
+// Tasks. loop() is the UI task (Arduino's loopTask, pinned to core 1) and
+// owns LVGL; WiFi and MQTT run in the network task on the other core.
+#define NETWORK_TASK_CORE 0
+#define NETWORK_TASK_STACK 6144       // Bytes
+#define NETWORK_TASK_PRIORITY 1
+#define NETWORK_TASK_MAX_WAIT 100     // Longest wait for socket data or commands in ms
+#define NET_EVENT_QUEUE_SIZE 32       // Status messages waiting for the UI task, power of two
+#define NET_COMMAND_QUEUE_SIZE 16     // Commands waiting to be published, power of two
 
 // Data update intervals
-#define DATA_UPDATE_INTERVAL 2000     // Main data update timer in ms
+#define DATA_UPDATE_INTERVAL 2000     // Test mode data simulation timer in ms
+#define STATUS_ICON_CHECK_INTERVAL 500 // WiFi/MQTT header icon check in ms
 #define CONNECTION_CHECK_INTERVAL 10000  // MQTT connection check in ms
 #define TEST_MODE_TEMP_UPDATE 30000   // Temperature simulation interval in test mode
 
@@ -43,16 +91,23 @@
 #define INDEV_LONG_PRESS_TIME 400     // Long press time in ms
 #define INDEV_SCROLL_LIMIT 5          // Scroll limit for touch
 
-// Memory configuration
-#define MQTT_JSON_BUFFER_SIZE 200     // JSON document buffer size
+// Unit state snapshot in NVS
+#define UNIT_STATE_NAMESPACE "acstate"
+#define UNIT_STATE_KEY "units"
+#define UNIT_STATE_SAVE_DELAY 60000   // Changes are collected this long before one flash write, in ms
 
 // WiFi configuration
-#define WIFI_CONNECTION_TIMEOUT 20    // WiFi connection timeout in iterations (20 * 500ms = 10s)
-#define WIFI_CHECK_DELAY 500         // Delay between WiFi connection checks in ms
+#define WIFI_CONNECTION_TIMEOUT 10000 // WiFi connect attempt timeout in ms, then WiFi.begin() is retried
 
 // MQTT configuration  
-#define MQTT_RECONNECT_DELAY 5000    // MQTT reconnection delay in ms
-#define MQTT_SUBSCRIPTION_DELAY 1000 // Delay after MQTT subscriptions in ms
+#define MQTT_RECONNECT_DELAY 1000      // First MQTT reconnect backoff in ms, doubles after each failure
+#define MQTT_RECONNECT_DELAY_MAX 60000 // Longest MQTT reconnect backoff in ms
+#define MQTT_RECONNECT_JITTER 25       // Random spread on each backoff in percent (+/-)
+#define MQTT_SOCKET_TIMEOUT 2          // Seconds connect() may wait for the broker
+#define COMMAND_COALESCE_WINDOW 400    // Temperature commands wait this long for further +/- presses, in ms
+#define COMMAND_RATE_BURST 3           // Commands that may be published back to back
+#define COMMAND_RATE_INTERVAL 150      // After a burst, one command per this many ms
+#define COMMAND_CONFIRM_TIMEOUT 5000   // Status values are held back this long for an unconfirmed command, in ms
 
 // Hardware validation macros
 #define VALIDATE_UNIT_INDEX(idx) ((idx) >= 0 && (idx) < numUnits)
@@ -14,6 +14,14 @@
 // Topic types for status
 #define MQTT_STATUS "status"
 
+// Subscribe to the status of all units with one wildcard subscription
+// instead of one subscription per unit. Messages for topics that are not
+// in the unit list are ignored by the callback.
+#ifndef MQTT_STATUS_WILDCARD
+#define MQTT_STATUS_WILDCARD 1
+#endif
+#define MQTT_STATUS_WILDCARD_TOPIC MQTT_BASE_TOPIC "/+/" MQTT_STATUS
+
 // Topic generation helpers
 #define MQTT_TOPIC_MAX_LENGTH 100
 #define MQTT_BASE_TOPIC "hcy/airco"
@@ -68,68 +76,121 @@ inline void generateStatusTopic(char* buffer, const char* unitTopic) {
   generateMQTTTopic(buffer, unitTopic, MQTT_STATUS);
 }
 
+// Enum <-> MQTT value tables
+// One table per enum, the array index is the ESP32 index. Decoding hashes
+// the length and the first and last character into a 16 slot table that is
+// generated at compile time; a static_assert guarantees the hash is perfect
+// for each table, so a lookup is one hash, one slot and one compare.
+#define MQTT_ENUM_HASH_SIZE 16
+
+struct MQTTEnumTable {
+  const char* const* values;
+  uint8_t count;                     // At most 8
+  uint8_t lengths[8];
+  int8_t slots[MQTT_ENUM_HASH_SIZE]; // Slot -> index, -1 when empty
+};
+
+constexpr uint8_t mqttStrLen(const char* s) {
+  return *s ? 1 + mqttStrLen(s + 1) : 0;
+}
+
+constexpr uint8_t mqttEnumHash(uint8_t length, char first, char last) {
+  return (uint8_t)(length * 2 + first + last) & (MQTT_ENUM_HASH_SIZE - 1);
+}
+
+constexpr uint8_t mqttEnumValueHash(const char* value) {
+  return mqttEnumHash(mqttStrLen(value), value[0], value[mqttStrLen(value) - 1]);
+}
+
+// Index of the value that hashes to slot, -1 if none (searched from the end)
+constexpr int8_t mqttEnumSlotIndex(const char* const* values, int count, int slot) {
+  return count == 0 ? -1
+       : mqttEnumValueHash(values[count - 1]) == slot ? count - 1
+       : mqttEnumSlotIndex(values, count - 1, slot);
+}
+
+// True when no two values share a slot
+constexpr bool mqttEnumHashIsPerfect(const char* const* values, int count, int i = 0, int j = 1) {
+  return i >= count - 1 ? true
+       : j >= count ? mqttEnumHashIsPerfect(values, count, i + 1, i + 2)
+       : mqttEnumValueHash(values[i]) != mqttEnumValueHash(values[j]) && mqttEnumHashIsPerfect(values, count, i, j + 1);
+}
+
+constexpr uint8_t mqttEnumLength(const char* const* values, int count, int i) {
+  return i < count ? mqttStrLen(values[i]) : 0;
+}
+
+constexpr const char* MQTT_MODE_VALUES[] = {MQTT_MODE_COOL, MQTT_MODE_HEAT, MQTT_MODE_FAN_ONLY, MQTT_MODE_AUTO, MQTT_MODE_DRY};
+constexpr const char* MQTT_FAN_VALUES[] = {MQTT_FAN_LOW, MQTT_FAN_MEDIUM, MQTT_FAN_HIGH, MQTT_FAN_POWERFUL};
+constexpr const char* MQTT_SWING_VALUES[] = {MQTT_SWING_SWING, MQTT_SWING_POSITION_1, MQTT_SWING_POSITION_2,
+                                             MQTT_SWING_POSITION_3, MQTT_SWING_POSITION_4};
+
+// Slot and length initializers for an MQTTEnumTable
+#define MQTT_ENUM_SLOTS4(values, count, s) \
+  mqttEnumSlotIndex(values, count, s), mqttEnumSlotIndex(values, count, s + 1), \
+  mqttEnumSlotIndex(values, count, s + 2), mqttEnumSlotIndex(values, count, s + 3)
+#define MQTT_ENUM_LENGTHS4(values, count, i) \
+  mqttEnumLength(values, count, i), mqttEnumLength(values, count, i + 1), \
+  mqttEnumLength(values, count, i + 2), mqttEnumLength(values, count, i + 3)
+#define MQTT_ENUM_TABLE(values, count) { \
+  values, count, \
+  { MQTT_ENUM_LENGTHS4(values, count, 0), MQTT_ENUM_LENGTHS4(values, count, 4) }, \
+  { MQTT_ENUM_SLOTS4(values, count, 0), MQTT_ENUM_SLOTS4(values, count, 4), \
+    MQTT_ENUM_SLOTS4(values, count, 8), MQTT_ENUM_SLOTS4(values, count, 12) } }
+
+constexpr MQTTEnumTable MQTT_MODES = MQTT_ENUM_TABLE(MQTT_MODE_VALUES, 5);
+constexpr MQTTEnumTable MQTT_FANS = MQTT_ENUM_TABLE(MQTT_FAN_VALUES, 4);
+constexpr MQTTEnumTable MQTT_SWINGS = MQTT_ENUM_TABLE(MQTT_SWING_VALUES, 5);
+
+// The first character alone is not enough: all swing positions start with 'p'
+static_assert(mqttEnumHashIsPerfect(MQTT_MODE_VALUES, 5), "MQTT mode values collide, change mqttEnumHash");
+static_assert(mqttEnumHashIsPerfect(MQTT_FAN_VALUES, 4), "MQTT fan values collide, change mqttEnumHash");
+static_assert(mqttEnumHashIsPerfect(MQTT_SWING_VALUES, 5), "MQTT swing values collide, change mqttEnumHash");
+
+// Index for an MQTT value of the given length (not NUL terminated), -1 if unknown
+inline int mqttEnumDecode(const MQTTEnumTable& table, const char* value, size_t length) {
+  if (length == 0 || length > 255) return -1;
+  int index = table.slots[mqttEnumHash(length, value[0], value[length - 1])];
+  if (index < 0 || table.lengths[index] != length) return -1;
+  return memcmp(table.values[index], value, length) == 0 ? index : -1;
+}
+
+// MQTT value for an index, the first value when out of range
+inline const char* mqttEnumEncode(const MQTTEnumTable& table, uint8_t index) {
+  return table.values[index < table.count ? index : 0];
+}
+
 // Function to convert mode index to MQTT string
 inline const char* getMQTTModeString(uint8_t mode) {
-  switch(mode) {
-    case 0: return MQTT_MODE_COOL;
-    case 1: return MQTT_MODE_HEAT;
-    case 2: return MQTT_MODE_FAN_ONLY;
-    case 3: return MQTT_MODE_AUTO;
-    case 4: return MQTT_MODE_DRY;
-    default: return MQTT_MODE_COOL;
-  }
+  return mqttEnumEncode(MQTT_MODES, mode);
 }
 
 // Function to convert fan speed index to MQTT string
 inline const char* getMQTTFanString(uint8_t fanSpeed) {
-  switch(fanSpeed) {
-    case 0: return MQTT_FAN_LOW;
-    case 1: return MQTT_FAN_MEDIUM;
-    case 2: return MQTT_FAN_HIGH;
-    case 3: return MQTT_FAN_POWERFUL;
-    default: return MQTT_FAN_LOW;
-  }
+  return mqttEnumEncode(MQTT_FANS, fanSpeed);
 }
 
 // Function to convert swing mode index to MQTT string
 inline const char* getMQTTSwingString(uint8_t swingMode) {
-  switch(swingMode) {
-    case 0: return MQTT_SWING_SWING;
-    case 1: return MQTT_SWING_POSITION_1;
-    case 2: return MQTT_SWING_POSITION_2;
-    case 3: return MQTT_SWING_POSITION_3;
-    case 4: return MQTT_SWING_POSITION_4;
-    default: return MQTT_SWING_SWING;
-  }
+  return mqttEnumEncode(MQTT_SWINGS, swingMode);
 }
 
 // Function to convert MQTT mode string to index
 inline uint8_t getModeIndexFromMQTT(const char* mode) {
-  if (strcmp(mode, MQTT_MODE_COOL) == 0) return 0;
-  if (strcmp(mode, MQTT_MODE_HEAT) == 0) return 1;
-  if (strcmp(mode, MQTT_MODE_FAN_ONLY) == 0) return 2;
-  if (strcmp(mode, MQTT_MODE_AUTO) == 0) return 3;
-  if (strcmp(mode, MQTT_MODE_DRY) == 0) return 4;
-  return 0; // Default to cool
+  int index = mqttEnumDecode(MQTT_MODES, mode, strlen(mode));
+  return index < 0 ? 0 : index; // Default to cool
 }
 
 // Function to convert MQTT fan string to index
 inline uint8_t getFanIndexFromMQTT(const char* fan) {
-  if (strcmp(fan, MQTT_FAN_LOW) == 0) return 0;
-  if (strcmp(fan, MQTT_FAN_MEDIUM) == 0) return 1;
-  if (strcmp(fan, MQTT_FAN_HIGH) == 0) return 2;
-  if (strcmp(fan, MQTT_FAN_POWERFUL) == 0) return 3;
-  return 0; // Default to low
+  int index = mqttEnumDecode(MQTT_FANS, fan, strlen(fan));
+  return index < 0 ? 0 : index; // Default to low
 }
 
 // Function to convert MQTT swing string to index
 inline uint8_t getSwingIndexFromMQTT(const char* swing) {
-  if (strcmp(swing, MQTT_SWING_SWING) == 0) return 0;
-  if (strcmp(swing, MQTT_SWING_POSITION_1) == 0) return 1;
-  if (strcmp(swing, MQTT_SWING_POSITION_2) == 0) return 2;
-  if (strcmp(swing, MQTT_SWING_POSITION_3) == 0) return 3;
-  if (strcmp(swing, MQTT_SWING_POSITION_4) == 0) return 4;
-  return 0; // Default to swing
+  int index = mqttEnumDecode(MQTT_SWINGS, swing, strlen(swing));
+  return index < 0 ? 0 : index; // Default to swing
 }
 
 #endif // MQTT_CONFIG_H
\ No newline at end of file
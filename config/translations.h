@@ -49,8 +49,8 @@ typedef enum {
 #define TXT_CONFIRMATION "Confirmation"
 
 // Notification Messages
-#define TXT_ALL_UNITS_ON "All units turned ON"
-#define TXT_ALL_UNITS_OFF "All units turned OFF"
+#define TXT_ALL_UNITS_ON "Sending ON to all units..."
+#define TXT_ALL_UNITS_OFF "Sending OFF to all units..."
 
 // Status Messages  
 #define TXT_MQTT_CONNECTION_OK "MQTT connection: OK"
@@ -0,0 +1,274 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal Arduino core for the host build: timing, GPIO, tasks, String and Serial.
+// Only what the controller sketch and UI files use is provided.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <math.h>
+#include <ctype.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define RISING 1
+#define FALLING 2
+#define CHANGE 3
+#define IRAM_ATTR
+#define digitalPinToInterrupt(p) (p)
+
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Time since the host program started
+inline std::chrono::steady_clock::time_point hostStartTime = std::chrono::steady_clock::now();
+
+inline unsigned long micros() {
+  using namespace std::chrono;
+  return (unsigned long)duration_cast<microseconds>(steady_clock::now() - hostStartTime).count();
+}
+
+inline unsigned long millis() {
+  return micros() / 1000;
+}
+
+inline void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(unsigned int us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+// GPIO: outputs are ignored, inputs read through a hook so stubs can drive pins
+inline int (*hostPinReadHook)(uint8_t pin) = nullptr;
+
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline void digitalWrite(uint8_t pin, uint8_t val) {}
+inline int digitalRead(uint8_t pin) {
+  return hostPinReadHook ? hostPinReadHook(pin) : HIGH;
+}
+
+// Background threads stand in for interrupts and esp_timer tasks. They
+// are stopped and joined at exit, before the globals they use go away.
+inline std::atomic<bool> hostStopping{false};
+inline std::vector<std::thread> hostThreads;
+
+inline void hostStopThreads() {
+  hostStopping = true;
+  for (std::thread &t : hostThreads) t.join();
+  hostThreads.clear();
+}
+
+template <typename F>
+inline void hostStartThread(F body) {
+  if (hostThreads.empty()) atexit(hostStopThreads);
+  hostThreads.emplace_back(body);
+}
+
+// FreeRTOS tasks, one thread each; the main thread is the loop task.
+// Task bodies loop forever, so at exit vTaskDelay() unwinds the task with
+// an exception instead of returning.
+struct HostTask {
+  std::mutex lock;
+  std::condition_variable wake;
+  uint32_t notified = 0; // Task notification value, counting
+};
+typedef HostTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+typedef uint32_t TickType_t;
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdPASS 1
+#define pdTRUE 1
+#define pdFALSE 0
+
+struct HostTaskExit {};
+
+// Tasks live until the program ends
+inline thread_local HostTask *hostCurrentTask = nullptr;
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+  if (!hostCurrentTask) hostCurrentTask = new HostTask();
+  return hostCurrentTask;
+}
+
+inline int xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stackBytes, void *arg,
+                                   unsigned priority, TaskHandle_t *handle, int core) {
+  HostTask *created = new HostTask();
+  if (handle) *handle = created; // Before the task runs, as FreeRTOS does
+  hostStartThread([task, arg, created] {
+    hostCurrentTask = created;
+    try {
+      task(arg);
+    } catch (const HostTaskExit &) {
+    }
+  });
+  return pdPASS;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t task) {
+  {
+    std::lock_guard<std::mutex> guard(task->lock);
+    task->notified++;
+  }
+  task->wake.notify_one();
+}
+
+inline uint32_t ulTaskNotifyTake(int clearCountOnExit, TickType_t ticks) {
+  HostTask *task = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> guard(task->lock);
+  task->wake.wait_for(guard, std::chrono::milliseconds(ticks), [task] { return task->notified > 0; });
+  uint32_t count = task->notified;
+  if (count > 0) task->notified = clearCountOnExit ? 0 : count - 1;
+  return count;
+}
+
+inline void vTaskDelay(TickType_t ticks) {
+  if (hostStopping) throw HostTaskExit();
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+// Pin interrupts: a thread polls the inputs every ms and calls the
+// handler on the requested edge
+struct HostInterrupt {
+  uint8_t pin;
+  void (*handler)();
+  int mode;
+  int level;
+};
+inline std::vector<HostInterrupt> hostInterrupts;
+inline std::mutex hostInterruptLock;
+
+inline void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+  std::lock_guard<std::mutex> guard(hostInterruptLock);
+  bool first = hostInterrupts.empty();
+  hostInterrupts.push_back({pin, handler, mode, digitalRead(pin)});
+  if (!first) return;
+  hostStartThread([] {
+    while (!hostStopping) {
+      {
+        std::lock_guard<std::mutex> guard(hostInterruptLock);
+        for (HostInterrupt &i : hostInterrupts) {
+          int level = digitalRead(i.pin);
+          if (level == i.level) continue;
+          i.level = level;
+          if (i.mode == CHANGE || (i.mode == FALLING && level == LOW) || (i.mode == RISING && level == HIGH)) {
+            i.handler();
+          }
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+}
+
+inline long random(long howbig) {
+  return howbig > 0 ? rand() % howbig : 0;
+}
+
+inline long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+inline bool psramFound() {
+  return false;
+}
+
+// Arduino String, enough for the sketch's formatting and comparisons
+class String {
+public:
+  String(const char *s = "") : _s(s ? s : "") {}
+  String(const std::string &s) : _s(s) {}
+  String(int v) : _s(std::to_string(v)) {}
+  String(unsigned int v) : _s(std::to_string(v)) {}
+  String(long v) : _s(std::to_string(v)) {}
+  String(unsigned long v) : _s(std::to_string(v)) {}
+  String(double v, unsigned int decimals = 2) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    _s = buf;
+  }
+
+  const char *c_str() const { return _s.c_str(); }
+  unsigned int length() const { return _s.length(); }
+  void toLowerCase() {
+    for (char &c : _s) c = tolower((unsigned char)c);
+  }
+  bool operator==(const char *s) const { return _s == s; }
+  bool operator==(const String &s) const { return _s == s._s; }
+  String operator+(const String &s) const { return String(_s + s._s); }
+  friend String operator+(const char *a, const String &b) { return String(std::string(a) + b._s); }
+
+private:
+  std::string _s;
+};
+
+// Serial output goes to stdout, tools can redirect it
+inline FILE *hostSerialOut = stdout;
+
+class HardwareSerial {
+public:
+  void begin(unsigned long baud) {}
+  size_t print(const char *s) { return fputs(s, hostSerialOut) >= 0 ? strlen(s) : 0; }
+  size_t print(const String &s) { return print(s.c_str()); }
+  size_t print(char c) { return fputc(c, hostSerialOut) != EOF; }
+  size_t print(unsigned char v) { return out("%u", v); }
+  size_t print(int v) { return out("%d", v); }
+  size_t print(unsigned int v) { return out("%u", v); }
+  size_t print(long v) { return out("%ld", v); }
+  size_t print(unsigned long v) { return out("%lu", v); }
+  size_t print(double v, int decimals = 2) { return out("%.*f", decimals, v); }
+  template <typename T>
+  size_t println(T v) { size_t n = print(v); return n + print('\n'); }
+  size_t println() { return print('\n'); }
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vfprintf(hostSerialOut, fmt, args);
+    va_end(args);
+    return n > 0 ? n : 0;
+  }
+  size_t write(uint8_t c) { return print((char)c); }
+  size_t write(const uint8_t *buf, size_t len) { return fwrite(buf, 1, len, hostSerialOut); }
+  int available() { return 0; }
+  int availableForWrite() { return 128; } // Like the ESP32 UART FIFO
+  int read() { return -1; }
+  void flush() { fflush(hostSerialOut); }
+
+private:
+  size_t out(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vfprintf(hostSerialOut, fmt, args);
+    va_end(args);
+    return n > 0 ? n : 0;
+  }
+};
+
+inline HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,66 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+// Host stand-in for the ESP32 Preferences (NVS) library. Every key is a
+// file <hostPreferencesDir>/<namespace>.<key>, so stored values survive
+// between runs like they do in flash. Only the byte blob calls are
+// provided, that is all the sketch uses.
+
+#include <Arduino.h>
+#include <string>
+#include <sys/stat.h>
+
+inline const char *hostPreferencesDir = "nvs";
+
+class Preferences {
+public:
+  bool begin(const char *name, bool readOnly = false) {
+    _name = name;
+    _readOnly = readOnly;
+    if (!readOnly) mkdir(hostPreferencesDir, 0755);
+    return true;
+  }
+  void end() { _name.clear(); }
+
+  size_t putBytes(const char *key, const void *value, size_t len) {
+    if (_name.empty() || _readOnly) return 0;
+    FILE *f = fopen(path(key).c_str(), "wb");
+    if (!f) return 0;
+    size_t written = fwrite(value, 1, len, f);
+    fclose(f);
+    putCount++;
+    return written;
+  }
+
+  size_t getBytesLength(const char *key) {
+    struct stat st;
+    if (_name.empty() || stat(path(key).c_str(), &st) != 0) return 0;
+    return st.st_size;
+  }
+
+  size_t getBytes(const char *key, void *buf, size_t maxLen) {
+    size_t len = getBytesLength(key);
+    if (len == 0 || len > maxLen) return 0;
+    FILE *f = fopen(path(key).c_str(), "rb");
+    if (!f) return 0;
+    size_t read = fread(buf, 1, len, f);
+    fclose(f);
+    return read;
+  }
+
+  bool remove(const char *key) {
+    return !_name.empty() && ::remove(path(key).c_str()) == 0;
+  }
+
+  uint32_t putCount = 0; // Number of writes, to check write coalescing
+
+private:
+  std::string path(const char *key) const {
+    return std::string(hostPreferencesDir) + "/" + _name + "." + key;
+  }
+
+  std::string _name;
+  bool _readOnly = false;
+};
+
+#endif // HOST_PREFERENCES_H
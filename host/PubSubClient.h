@@ -0,0 +1,95 @@
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+// Host stand-in for PubSubClient. connect() always succeeds, published
+// messages are counted and printed, and messages queued with
+// injectMessage() are delivered to the callback from loop(), the same
+// place the real client delivers them. injectMessage() is called from the
+// host's main thread while loop() runs in the network task, so the inbox
+// has a lock, and it makes the WiFiClient readable to wake that task.
+// loop() also ends the network task at exit, which never calls vTaskDelay().
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#define MQTT_CONNECTED 0
+#define MQTT_DISCONNECTED -1
+
+typedef void (*MQTT_CALLBACK_SIGNATURE)(char *, uint8_t *, unsigned int);
+
+class PubSubClient {
+public:
+  PubSubClient(WiFiClient &client) : _client(&client) {}
+
+  PubSubClient &setServer(const char *domain, uint16_t port) { return *this; }
+  PubSubClient &setCallback(MQTT_CALLBACK_SIGNATURE callback) {
+    _callback = callback;
+    return *this;
+  }
+  PubSubClient &setBufferSize(uint16_t size) { return *this; }
+  PubSubClient &setSocketTimeout(uint16_t timeout) { return *this; }
+
+  bool connect(const char *id, const char *user, const char *pass) {
+    _connected = true;
+    return true;
+  }
+  void disconnect() { _connected = false; }
+  bool connected() { return _connected; }
+  int state() { return _connected ? MQTT_CONNECTED : MQTT_DISCONNECTED; }
+
+  bool subscribe(const char *topic) {
+    subscribeCount++;
+    return _connected;
+  }
+
+  bool publish(const char *topic, const char *payload) {
+    if (!_connected) return false;
+    publishCount++;
+    if (echoPublish) printf("[mqtt] publish %s %s\n", topic, payload);
+    return true;
+  }
+
+  bool loop() {
+    if (hostStopping) throw HostTaskExit();
+    _client->hostDrain();
+    while (_connected) {
+      std::pair<std::string, std::string> msg;
+      {
+        std::lock_guard<std::mutex> guard(_inboxLock);
+        if (_inbox.empty()) break;
+        msg = std::move(_inbox.front());
+        _inbox.pop_front();
+      }
+      if (_callback) {
+        _callback(&msg.first[0], (uint8_t *)&msg.second[0], msg.second.size());
+      }
+    }
+    return _connected;
+  }
+
+  // Queue an incoming message, delivered on the next loop()
+  void injectMessage(const char *topic, const char *payload) {
+    {
+      std::lock_guard<std::mutex> guard(_inboxLock);
+      _inbox.emplace_back(topic, payload);
+    }
+    _client->hostSignal();
+  }
+
+  uint32_t subscribeCount = 0;
+  uint32_t publishCount = 0;
+  bool echoPublish = true;
+
+private:
+  WiFiClient *_client;
+  MQTT_CALLBACK_SIGNATURE _callback = nullptr;
+  std::atomic<bool> _connected{false};
+  std::deque<std::pair<std::string, std::string>> _inbox;
+  std::mutex _inboxLock;
+};
+
+#endif // HOST_PUBSUBCLIENT_H
@@ -0,0 +1,20 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+// Host stand-in for the ESP32 SPI driver, the touch stub never talks SPI
+
+#include <Arduino.h>
+
+#define VSPI 3
+#define HSPI 2
+
+class SPIClass {
+public:
+  SPIClass(uint8_t bus = HSPI) {}
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {}
+  void end() {}
+};
+
+inline SPIClass SPI;
+
+#endif // HOST_SPI_H
@@ -0,0 +1,121 @@
+#ifndef HOST_TFT_ESPI_H
+#define HOST_TFT_ESPI_H
+
+// Host stand-in for TFT_eSPI with a fake SPI bus.
+// Pixels are copied into a memory framebuffer and every transfer is given
+// the duration it would take on the real bus, so the overlap between LVGL
+// rendering and DMA flushing can be measured off-device.
+
+#include <Arduino.h>
+#include <chrono>
+
+// SPI clock used by the ILI9341 on the ESP32-2432S028
+#ifndef FAKE_SPI_CLOCK_HZ
+#define FAKE_SPI_CLOCK_HZ 40000000UL
+#endif
+
+// Fixed cost per transfer for CS toggling and the address window commands
+#ifndef FAKE_SPI_SETUP_US
+#define FAKE_SPI_SETUP_US 20
+#endif
+
+#ifndef FAKE_TFT_WIDTH
+#define FAKE_TFT_WIDTH 240
+#endif
+
+#ifndef FAKE_TFT_HEIGHT
+#define FAKE_TFT_HEIGHT 320
+#endif
+
+// Counters collected by the fake SPI bus
+struct FakeSpiStats {
+  uint32_t transfers;      // Number of pixel transfers started
+  uint64_t bytes;          // Pixel bytes sent
+  uint64_t busyMicros;     // Total simulated time the bus was busy
+  uint64_t blockedMicros;  // Time the CPU was blocked waiting for the bus
+};
+
+class TFT_eSPI {
+public:
+  TFT_eSPI() : _swapBytes(false), _x(0), _y(0), _w(0), _h(0), _busyUntil(0) {
+    memset(&stats, 0, sizeof(stats));
+    memset(framebuffer, 0, sizeof(framebuffer));
+  }
+
+  void init() {}
+  void setRotation(uint8_t r) {}
+  bool initDMA() { return true; }
+  void setSwapBytes(bool swap) { _swapBytes = swap; }
+
+  void startWrite() {}
+  void endWrite() {}
+
+  void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+    _x = x; _y = y; _w = w; _h = h;
+  }
+
+  // Blocking transfer, the CPU waits for the whole stripe
+  void pushColors(uint16_t *data, uint32_t len, bool swap = true) {
+    dmaWait();
+    copyToFramebuffer(data, len, swap);
+    uint64_t end = startTransfer(len);
+    blockUntil(end);
+  }
+
+  // Asynchronous transfer, returns as soon as the transfer is queued
+  void pushPixelsDMA(uint16_t *image, uint32_t len) {
+    dmaWait();
+    copyToFramebuffer(image, len, _swapBytes);
+    _busyUntil = startTransfer(len);
+  }
+
+  bool dmaBusy() { return nowMicros() < _busyUntil; }
+
+  void dmaWait() { blockUntil(_busyUntil); }
+
+  void resetStats() { memset(&stats, 0, sizeof(stats)); }
+
+  FakeSpiStats stats;
+  uint16_t framebuffer[FAKE_TFT_WIDTH * FAKE_TFT_HEIGHT];
+
+private:
+  static uint64_t nowMicros() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+
+  uint64_t startTransfer(uint32_t len) {
+    uint64_t bytes = (uint64_t)len * 2;
+    uint64_t duration = FAKE_SPI_SETUP_US + bytes * 8 * 1000000ULL / FAKE_SPI_CLOCK_HZ;
+    stats.transfers++;
+    stats.bytes += bytes;
+    stats.busyMicros += duration;
+    return nowMicros() + duration;
+  }
+
+  void blockUntil(uint64_t end) {
+    uint64_t start = nowMicros();
+    if (start >= end) return;
+    while (nowMicros() < end) {} // Spin like the real CPU would, sleeping overshoots
+    stats.blockedMicros += end - start;
+  }
+
+  void copyToFramebuffer(const uint16_t *data, uint32_t len, bool swap) {
+    uint32_t i = 0;
+    for (int32_t row = 0; row < _h && i < len; row++) {
+      for (int32_t col = 0; col < _w && i < len; col++, i++) {
+        int32_t px = _x + col;
+        int32_t py = _y + row;
+        if (px < 0 || py < 0 || px >= FAKE_TFT_WIDTH || py >= FAKE_TFT_HEIGHT) continue;
+        uint16_t c = data[i];
+        framebuffer[py * FAKE_TFT_WIDTH + px] = swap ? (uint16_t)((c << 8) | (c >> 8)) : c;
+      }
+    }
+  }
+
+  bool _swapBytes;
+  int32_t _x, _y, _w, _h;
+  uint64_t _busyUntil;
+};
+
+#endif // HOST_TFT_ESPI_H
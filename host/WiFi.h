@@ -0,0 +1,57 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// Host stand-in for the ESP32 WiFi stack. The host is always "connected"
+// so the normal startup path can run against the PubSubClient stub.
+
+#include <Arduino.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_CONNECTED = 3,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+class IPAddress {
+public:
+  String toString() const { return String("127.0.0.1"); }
+};
+
+// Stands in for the MQTT socket: the network task selects on fd(), the
+// PubSubClient stub makes it readable while scripted messages wait
+class WiFiClient {
+public:
+  WiFiClient() : _fd(eventfd(0, EFD_NONBLOCK)) {}
+  int fd() const { return _fd; }
+  int available() { return 0; } // The stub has no buffered bytes
+
+  void hostSignal() {
+    uint64_t one = 1;
+    (void)!write(_fd, &one, sizeof(one));
+  }
+  void hostDrain() {
+    uint64_t count;
+    (void)!read(_fd, &count, sizeof(count));
+  }
+
+private:
+  int _fd;
+};
+
+class WiFiClass {
+public:
+  void begin(const char *ssid, const char *password) { _status = WL_CONNECTED; }
+  void disconnect() { _status = WL_DISCONNECTED; }
+  wl_status_t status() { return _status; }
+  IPAddress localIP() { return IPAddress(); }
+  int8_t RSSI() { return -50; }
+
+private:
+  wl_status_t _status = WL_IDLE_STATUS;
+};
+
+inline WiFiClass WiFi;
+
+#endif // HOST_WIFI_H
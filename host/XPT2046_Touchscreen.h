@@ -0,0 +1,78 @@
+#ifndef HOST_XPT2046_TOUCHSCREEN_H
+#define HOST_XPT2046_TOUCHSCREEN_H
+
+// Host stand-in for the XPT2046 touch controller. Touches come from a
+// scripted timeline of raw controller samples (see host_main.cpp for the
+// script format), and the IRQ pin (hostTouchIrqPin) reads LOW while a
+// touch is down. The sketch samples from another thread, so the script
+// is only read once hostTouchScriptStart is set.
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <vector>
+
+class TS_Point {
+public:
+  TS_Point(int16_t x = 0, int16_t y = 0, int16_t z = 0) : x(x), y(y), z(z) {}
+  int16_t x, y, z;
+};
+
+// One scripted sample, the touch state from atMillis onward
+struct HostTouchEvent {
+  uint32_t atMillis;
+  bool down;
+  int16_t rawX;
+  int16_t rawY;
+};
+
+inline std::vector<HostTouchEvent> hostTouchScript;
+inline std::atomic<bool> hostTouchScriptRunning{false};
+inline uint32_t hostTouchScriptStart = 0; // millis() the script times count from
+inline uint8_t hostTouchIrqPin = 255;
+inline std::atomic<uint32_t> hostTouchReads{0}; // getPoint() calls, each one is an SPI transfer on the device
+
+// Latest scripted event at or before now, nullptr before the first one
+inline const HostTouchEvent *hostCurrentTouch() {
+  if (!hostTouchScriptRunning) return nullptr;
+  const HostTouchEvent *current = nullptr;
+  uint32_t now = millis() - hostTouchScriptStart;
+  for (const HostTouchEvent &e : hostTouchScript) {
+    if (e.atMillis > now) break;
+    current = &e;
+  }
+  return current;
+}
+
+class XPT2046_Touchscreen {
+public:
+  XPT2046_Touchscreen(uint8_t cs, uint8_t irq = 255) : _irq(irq) {
+    if (irq != 255) hostTouchIrqPin = irq;
+    hostPinReadHook = readIrq;
+  }
+
+  bool begin(SPIClass &spi) { return true; }
+  void setRotation(uint8_t r) {}
+
+  bool touched() {
+    const HostTouchEvent *e = hostCurrentTouch();
+    return e && e->down;
+  }
+
+  TS_Point getPoint() {
+    hostTouchReads++;
+    const HostTouchEvent *e = hostCurrentTouch();
+    if (!e || !e->down) return TS_Point();
+    return TS_Point(e->rawX, e->rawY, 1000);
+  }
+
+private:
+  static int readIrq(uint8_t pin) {
+    if (pin != hostTouchIrqPin) return HIGH;
+    const HostTouchEvent *e = hostCurrentTouch();
+    return (e && e->down) ? LOW : HIGH;
+  }
+
+  uint8_t _irq;
+};
+
+#endif // HOST_XPT2046_TOUCHSCREEN_H
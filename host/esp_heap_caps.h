@@ -0,0 +1,27 @@
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+// Host stand-in for the ESP-IDF capability allocator, all memory is plain heap
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_DMA      (1 << 3)
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT  (1 << 12)
+
+inline void *heap_caps_malloc(size_t size, uint32_t caps) {
+  return malloc(size);
+}
+
+inline void heap_caps_free(void *ptr) {
+  free(ptr);
+}
+
+inline size_t heap_caps_get_free_size(uint32_t caps) {
+  return 0;
+}
+
+#endif // HOST_ESP_HEAP_CAPS_H
@@ -0,0 +1,59 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+// Host stand-in for the ESP-IDF esp_timer API. Each timer gets its own
+// thread, like the callbacks run in the esp_timer task on the device.
+// Only periodic timers are provided.
+
+#include <Arduino.h>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_ERR_INVALID_STATE 0x103
+
+typedef void (*esp_timer_cb_t)(void *arg);
+
+struct esp_timer_create_args_t {
+  esp_timer_cb_t callback;
+  void *arg;
+  int dispatch_method;
+  const char *name;
+  bool skip_unhandled_events;
+};
+
+struct esp_timer {
+  esp_timer_cb_t callback;
+  void *arg;
+  std::atomic<uint64_t> periodUs{0}; // 0 while stopped
+};
+typedef esp_timer *esp_timer_handle_t;
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle) {
+  esp_timer *timer = new esp_timer();
+  timer->callback = args->callback;
+  timer->arg = args->arg;
+  *handle = timer;
+  hostStartThread([timer] {
+    while (!hostStopping) {
+      uint64_t period = timer->periodUs;
+      std::this_thread::sleep_for(std::chrono::microseconds(period ? period : 1000));
+      if (period && timer->periodUs) timer->callback(timer->arg);
+    }
+  });
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+  uint64_t stopped = 0;
+  return timer->periodUs.compare_exchange_strong(stopped, periodUs) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+inline esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  return timer->periodUs.exchange(0) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+inline int64_t esp_timer_get_time() {
+  return micros();
+}
+
+#endif // HOST_ESP_TIMER_H
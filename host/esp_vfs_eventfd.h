@@ -0,0 +1,19 @@
+#ifndef HOST_ESP_VFS_EVENTFD_H
+#define HOST_ESP_VFS_EVENTFD_H
+
+// Host stand-in for the ESP-IDF eventfd VFS. Linux has eventfd itself,
+// registering the driver does nothing.
+
+#include <sys/eventfd.h>
+#include <stddef.h>
+#include <esp_timer.h> // esp_err_t
+
+typedef struct {
+  size_t max_fds;
+} esp_vfs_eventfd_config_t;
+
+inline esp_err_t esp_vfs_eventfd_register(const esp_vfs_eventfd_config_t *config) {
+  return ESP_OK;
+}
+
+#endif // HOST_ESP_VFS_EVENTFD_H
@@ -0,0 +1,171 @@
+/*
+ * Host entry point for the AC controller UI
+ * Runs setup() and loop() from the sketch against the stubs in this
+ * directory, with touch and MQTT input replayed from a script file.
+ *
+ * Script format, one event per line, times in ms after setup() returns:
+ *   <ms> down <x> <y>          finger down (or moved) at screen coordinates
+ *   <ms> up                    finger lifted
+ *   <ms> mqtt <topic> <json>   incoming MQTT message, rest of line is payload
+ * Empty lines and lines starting with # are ignored.
+ */
+
+#include <Arduino.h>
+#include <vector>
+#include <string>
+#include "../src/ac_controller_lvgl.h"
+#include "../config/hardware_config.h"
+#include <Preferences.h>
+
+void setup();
+void loop();
+
+struct HostMqttEvent {
+  uint32_t atMillis;
+  std::string topic;
+  std::string payload;
+};
+
+static std::vector<HostMqttEvent> mqttScript;
+
+// Parse the script into the touch timeline and the MQTT message list
+static bool loadScript(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "Cannot open script %s\n", path);
+    return false;
+  }
+
+  char line[512];
+  int lineNumber = 0;
+  while (fgets(line, sizeof(line), f)) {
+    lineNumber++;
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '\0' || line[0] == '#') continue;
+
+    unsigned long ms;
+    char kind[8];
+    int used = 0;
+    if (sscanf(line, "%lu %7s %n", &ms, kind, &used) < 2) {
+      fprintf(stderr, "%s:%d: expected '<ms> <event>'\n", path, lineNumber);
+      continue;
+    }
+    const char *rest = line + used;
+
+    if (strcmp(kind, "down") == 0) {
+      int x, y;
+      if (sscanf(rest, "%d %d", &x, &y) != 2) {
+        fprintf(stderr, "%s:%d: expected '<ms> down <x> <y>'\n", path, lineNumber);
+        continue;
+      }
+      // Convert screen coordinates back to raw controller values
+      int16_t rawX = map(x, 0, TFT_WIDTH, TOUCH_RAW_MIN, TOUCH_RAW_MAX);
+      int16_t rawY = map(y, 0, TFT_HEIGHT, TOUCH_RAW_MIN, TOUCH_RAW_MAX);
+      hostTouchScript.push_back({(uint32_t)ms, true, rawX, rawY});
+    } else if (strcmp(kind, "up") == 0) {
+      hostTouchScript.push_back({(uint32_t)ms, false, 0, 0});
+    } else if (strcmp(kind, "mqtt") == 0) {
+      char topic[128];
+      int topicLen = 0;
+      if (sscanf(rest, "%127s %n", topic, &topicLen) != 1) {
+        fprintf(stderr, "%s:%d: expected '<ms> mqtt <topic> <payload>'\n", path, lineNumber);
+        continue;
+      }
+      mqttScript.push_back({(uint32_t)ms, topic, rest + topicLen});
+    } else {
+      fprintf(stderr, "%s:%d: unknown event '%s'\n", path, lineNumber, kind);
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+// Write the fake display framebuffer as a binary PPM image
+static bool dumpFramebuffer(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    fprintf(stderr, "Cannot write %s\n", path);
+    return false;
+  }
+  fprintf(f, "P6\n%d %d\n255\n", FAKE_TFT_WIDTH, FAKE_TFT_HEIGHT);
+  for (uint32_t i = 0; i < FAKE_TFT_WIDTH * FAKE_TFT_HEIGHT; i++) {
+    uint16_t c = tft.framebuffer[i];
+    uint8_t rgb[3] = {
+      (uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+      (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+      (uint8_t)((c & 0x1F) * 255 / 31)
+    };
+    fwrite(rgb, 1, 3, f);
+  }
+  fclose(f);
+  return true;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [--test-mode] [--script FILE] [--run-ms N] [--dump FILE.ppm] [--nvs DIR]\n"
+          "  --test-mode      use the dummy unit data instead of the MQTT stub\n"
+          "  --script FILE    replay touch and MQTT events from FILE\n"
+          "  --run-ms N       run loop() for N ms after setup (default 5000)\n"
+          "  --dump FILE.ppm  write the final screen contents to FILE.ppm\n"
+          "  --nvs DIR        keep the Preferences (NVS) files in DIR (default nvs)\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  const char *scriptPath = NULL;
+  const char *dumpPath = NULL;
+  uint32_t runMillis = 5000;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--test-mode") == 0) {
+      testMode = true;
+    } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+      scriptPath = argv[++i];
+    } else if (strcmp(argv[i], "--run-ms") == 0 && i + 1 < argc) {
+      runMillis = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+      dumpPath = argv[++i];
+    } else if (strcmp(argv[i], "--nvs") == 0 && i + 1 < argc) {
+      hostPreferencesDir = argv[++i];
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (scriptPath && !loadScript(scriptPath)) return 1;
+
+  hostTouchIrqPin = XPT2046_IRQ;
+  setup();
+
+  // Script times are relative to the end of setup()
+  uint32_t start = millis();
+  hostTouchScriptStart = start;
+  hostTouchScriptRunning = true;
+
+  // MQTT messages come from their own thread, on time while loop() waits
+  hostStartThread([start] {
+    size_t next = 0;
+    while (next < mqttScript.size() && !hostStopping) {
+      if (millis() - start >= mqttScript[next].atMillis) {
+        mqttClient.injectMessage(mqttScript[next].topic.c_str(), mqttScript[next].payload.c_str());
+        next++;
+      } else {
+        delay(1);
+      }
+    }
+  });
+
+  while (millis() - start < runMillis) {
+    loop();
+  }
+
+  printf("SPI transfers: %u, bytes: %llu, bus busy: %llu us, CPU blocked: %llu us\n",
+         tft.stats.transfers, (unsigned long long)tft.stats.bytes,
+         (unsigned long long)tft.stats.busyMicros, (unsigned long long)tft.stats.blockedMicros);
+  printf("Touch controller reads: %u\n", (unsigned)hostTouchReads);
+
+  if (dumpPath && !dumpFramebuffer(dumpPath)) return 1;
+  return 0;
+}
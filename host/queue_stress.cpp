@@ -0,0 +1,113 @@
+/*
+ * Stress run for the task queues (src/spsc_queue.h, src/task_messages.h)
+ * Two threads stand in for the network and the UI task and use the same
+ * queue types as the sketch: the network thread sends NetEvents and
+ * takes NetCommands, the UI thread the other way around, both at full
+ * speed. Every message carries its sequence number in all fields, so a
+ * lost, repeated, reordered or torn message is detected on arrival.
+ * Build with -fsanitize=thread to have the memory ordering checked too.
+ */
+
+#include <Arduino.h>
+#include "../src/task_messages.h"
+
+#define STRESS_MESSAGES_DEFAULT 2000000
+
+static NetEventQueue events;
+static NetCommandQueue commands;
+
+struct Side {
+  uint32_t sent;
+  uint32_t received;
+  uint32_t fullRetries; // Push attempts on a full queue
+  uint32_t errors;
+};
+
+static NetEvent makeEvent(uint32_t seq) {
+  NetEvent event = {};
+  event.type = NET_EVENT_STATUS;
+  event.unitIndex = (int8_t)(seq % 100);
+  event.receivedAt = seq;
+  event.status.present = seq & 0x3F;
+  event.status.currentTemp = (float)(seq % 1000);
+  event.status.isOn = seq & 1;
+  event.status.mode = seq % 5;
+  event.status.fanSpeed = seq % 4;
+  event.status.swingMode = seq % 5;
+  event.status.setpoint = (float)(seq % 30);
+  return event;
+}
+
+static bool eventMatches(const NetEvent &event, uint32_t seq) {
+  NetEvent expected = makeEvent(seq);
+  return event.type == expected.type && event.unitIndex == expected.unitIndex &&
+         event.receivedAt == expected.receivedAt && event.status.present == expected.status.present &&
+         event.status.currentTemp == expected.status.currentTemp && event.status.isOn == expected.status.isOn &&
+         event.status.mode == expected.status.mode && event.status.fanSpeed == expected.status.fanSpeed &&
+         event.status.swingMode == expected.status.swingMode && event.status.setpoint == expected.status.setpoint;
+}
+
+static NetCommand makeCommand(uint32_t seq) {
+  NetCommand cmd = {(int8_t)(seq % 100), (uint8_t)(seq % 5), (int16_t)(seq & 0x7FFF), (uint16_t)seq};
+  return cmd;
+}
+
+static bool commandMatches(const NetCommand &cmd, uint32_t seq) {
+  NetCommand expected = makeCommand(seq);
+  return cmd.unitIndex == expected.unitIndex && cmd.command == expected.command &&
+         cmd.value == expected.value && cmd.seq == expected.seq;
+}
+
+// Sends `total` items of one kind and receives `total` of the other,
+// interleaved like a task loop does
+template <typename Out, typename OutQueue, typename In, typename InQueue>
+static void runSide(OutQueue *out, InQueue *in, uint32_t total, Out (*make)(uint32_t),
+                    bool (*matches)(const In &, uint32_t), Side *side) {
+  uint32_t idleRounds = 0;
+  while (side->sent < total || side->received < total) {
+    bool idle = true;
+    if (side->sent < total) {
+      if (spscPush(out, make(side->sent))) {
+        side->sent++;
+        idle = false;
+      } else {
+        side->fullRetries++;
+      }
+    }
+    In item;
+    while (spscPop(in, &item)) {
+      if (!matches(item, side->received)) side->errors++;
+      side->received++;
+      idle = false;
+    }
+    // Let the other side run when both threads share a core; yield()
+    // alone hardly ever switches on Linux
+    if (!idle) idleRounds = 0;
+    else if (++idleRounds % 64 == 0) std::this_thread::sleep_for(std::chrono::microseconds(20));
+    else std::this_thread::yield();
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t total = argc > 1 ? strtoul(argv[1], NULL, 10) : STRESS_MESSAGES_DEFAULT;
+  Side network = {}, ui = {};
+
+  auto start = std::chrono::steady_clock::now();
+  std::thread networkThread([&] { runSide(&events, &commands, total, makeEvent, commandMatches, &network); });
+  std::thread uiThread([&] { runSide(&commands, &events, total, makeCommand, eventMatches, &ui); });
+  networkThread.join();
+  uiThread.join();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("queue,messages,per_second,full_retries,errors\n");
+  printf("events,%u,%.0f,%u,%u\n", (unsigned)ui.received, ui.received / seconds,
+         (unsigned)network.fullRetries, (unsigned)ui.errors);
+  printf("commands,%u,%.0f,%u,%u\n", (unsigned)network.received, network.received / seconds,
+         (unsigned)ui.fullRetries, (unsigned)network.errors);
+
+  // spscPush counts every full attempt as dropped, they must match the retries
+  bool ok = ui.errors == 0 && network.errors == 0 && events.dropped.load() == network.fullRetries &&
+            commands.dropped.load() == ui.fullRetries;
+  printf("%s\n", ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+/*
+ * Micro-benchmark for the MQTT status parser
+ * Compares parseStatusPayload() with the ArduinoJson code path that
+ * mqttCallback used before: copy the payload into a stack buffer,
+ * deserialize into StaticJsonDocument<200>, then look up every field
+ * with containsKey() and convert the enum strings with strcmp.
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../src/mqtt_status_parser.h"
+
+#define BENCH_ITERATIONS_DEFAULT 200000
+
+static const char *payloads[][2] = {
+  {"strings", "{\"hvac_mode\":\"fan_only\",\"power\":\"ON\",\"setpoint\":\"21.0\","
+              "\"current_temperature\":\"22.0\",\"fan_mode\":\"medium\",\"swing_mode\":\"position_3\"}"},
+  {"numbers", "{\"current_temperature\":23.5,\"power\":\"on\",\"hvac_mode\":\"cool\","
+              "\"fan_mode\":\"low\",\"swing_mode\":\"swing\",\"setpoint\":21}"},
+  {"partial", "{\"current_temperature\":24.1}"},
+};
+
+// The pre-parser mqttCallback body, minus the logging
+static bool parseWithArduinoJson(const uint8_t *payload, unsigned int length, ACStatus *status) {
+  char message[length + 1];
+  for (unsigned int i = 0; i < length; i++) {
+    message[i] = (char)payload[i];
+  }
+  message[length] = '\0';
+
+  StaticJsonDocument<200> doc;
+  DeserializationError error = deserializeJson(doc, message);
+  if (error) return false;
+
+  status->present = 0;
+  if (doc.containsKey("current_temperature")) {
+    status->currentTemp = doc["current_temperature"];
+    status->present |= STATUS_HAS_CURRENT_TEMP;
+  }
+  if (doc.containsKey("power")) {
+    const char *power = doc["power"];
+    status->isOn = (strcasecmp(power, "on") == 0);
+    status->present |= STATUS_HAS_POWER;
+  }
+  if (doc.containsKey("hvac_mode")) {
+    status->mode = getModeIndexFromMQTT(doc["hvac_mode"]);
+    status->present |= STATUS_HAS_MODE;
+  }
+  if (doc.containsKey("fan_mode")) {
+    status->fanSpeed = getFanIndexFromMQTT(doc["fan_mode"]);
+    status->present |= STATUS_HAS_FAN;
+  }
+  if (doc.containsKey("swing_mode")) {
+    status->swingMode = getSwingIndexFromMQTT(doc["swing_mode"]);
+    status->present |= STATUS_HAS_SWING;
+  }
+  if (doc.containsKey("setpoint")) {
+    status->setpoint = doc["setpoint"];
+    status->present |= STATUS_HAS_SETPOINT;
+  }
+  return true;
+}
+
+typedef bool (*ParseFn)(const uint8_t *, unsigned int, ACStatus *);
+
+// Average time per parse in ns; the checksum keeps the work from being optimized out
+static double timeParser(ParseFn parse, const uint8_t *payload, unsigned int length,
+                         uint32_t iterations, uint32_t *checksum) {
+  ACStatus status;
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < iterations; i++) {
+    parse(payload, length, &status);
+    *checksum += status.present + status.mode + status.fanSpeed + status.swingMode;
+  }
+  return (micros() - start) * 1000.0 / iterations;
+}
+
+static bool sameResult(const ACStatus &a, const ACStatus &b) {
+  if (a.present != b.present) return false;
+  if ((a.present & STATUS_HAS_CURRENT_TEMP) && a.currentTemp != b.currentTemp) return false;
+  if ((a.present & STATUS_HAS_POWER) && a.isOn != b.isOn) return false;
+  if ((a.present & STATUS_HAS_MODE) && a.mode != b.mode) return false;
+  if ((a.present & STATUS_HAS_FAN) && a.fanSpeed != b.fanSpeed) return false;
+  if ((a.present & STATUS_HAS_SWING) && a.swingMode != b.swingMode) return false;
+  if ((a.present & STATUS_HAS_SETPOINT) && a.setpoint != b.setpoint) return false;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  uint32_t iterations = BENCH_ITERATIONS_DEFAULT;
+  if (argc > 1) iterations = strtoul(argv[1], NULL, 10);
+  if (iterations == 0) iterations = 1;
+
+  printf("Stack: StaticJsonDocument<200> is %u bytes plus a payload copy, "
+         "the streaming parser's largest buffer is %u bytes\n",
+         (unsigned)sizeof(StaticJsonDocument<200>), (unsigned)STATUS_NUMBER_MAX_LENGTH);
+  printf("payload,bytes,arduinojson_ns,streaming_ns,speedup,same_result\n");
+
+  uint32_t checksum = 0;
+  for (const auto &p : payloads) {
+    const uint8_t *payload = (const uint8_t *)p[1];
+    unsigned int length = strlen(p[1]);
+
+    ACStatus a = {}, b = {};
+    bool okA = parseWithArduinoJson(payload, length, &a);
+    bool okB = parseStatusPayload(payload, length, &b);
+
+    double nsJson = timeParser(parseWithArduinoJson, payload, length, iterations, &checksum);
+    double nsStream = timeParser(parseStatusPayload, payload, length, iterations, &checksum);
+    printf("%s,%u,%.1f,%.1f,%.1fx,%s\n", p[0], length, nsJson, nsStream, nsJson / nsStream,
+           okA == okB && sameResult(a, b) ? "yes" : "NO");
+  }
+  printf("# checksum %u\n", checksum);
+  return 0;
+}
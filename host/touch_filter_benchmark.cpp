@@ -0,0 +1,264 @@
+/*
+ * Touch filter benchmark and trace replay
+ * Runs raw touch samples through touchFilterFeed() (src/touch_filter.h)
+ * and compares what LVGL would get with and without the filter: synthetic
+ * touches with known positions, then any trace files recorded with
+ * TOUCH_TRACE set to 1, replayed as they are. Exits with 1 when a touch
+ * loses its release or a synthetic trace goes over its error limit.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../src/touch_filter.h"
+
+#define BENCH_ITERATIONS_DEFAULT 2000
+
+// Largest distance in raw units between a filtered point and the finger.
+// The synthetic noise is +-25 per axis, so a finger that stands still may
+// be off by the noise but never by a spike. A drag adds the filter lag:
+// the median trails one point and the IIR about (256 - alpha) / alpha
+// more, on the drag below (36 raw units per sample) that is 1.3 samples.
+#define BENCH_MAX_ERROR 40
+#define BENCH_MAX_ERROR_DRAG 80
+
+struct Trace {
+  std::string name;
+  std::vector<TouchSample> samples;
+  std::vector<TouchSample> truth; // Finger position per sample, empty for recorded traces
+  double maxErrLimit;              // BENCH_MAX_ERROR*, synthetic traces only
+};
+
+// Small deterministic generator, the same traces on every run
+static uint32_t rngState = 12345;
+static int32_t rngNext(int32_t range) {
+  rngState = rngState * 1664525u + 1013904223u;
+  return (int32_t)((rngState >> 8) % (uint32_t)(2 * range + 1)) - range;
+}
+
+// A touch from (x0,y0) to (x1,y1) at the sample rate: light pressure at
+// both ends, +-noise on every sample and a spike every spikeEvery samples
+static void addSyntheticTouch(Trace *t, uint32_t *ms, int x0, int y0, int x1, int y1, int count,
+                              int noise, int spikeEvery) {
+  const uint32_t step = 1000 / TOUCH_SAMPLE_RATE;
+  for (int i = 0; i < count; i++) {
+    TouchSample truth;
+    truth.x = x0 + (x1 - x0) * i / (count > 1 ? count - 1 : 1);
+    truth.y = y0 + (y1 - y0) * i / (count > 1 ? count - 1 : 1);
+    truth.z = (i < 2 || i >= count - 2) ? 450 : 1100;
+    truth.down = true;
+    truth.at = *ms;
+
+    TouchSample s = truth;
+    s.x += rngNext(noise);
+    s.y += rngNext(noise);
+    if (spikeEvery > 0 && i % spikeEvery == spikeEvery / 2) {
+      s.x += 400;
+      s.y -= 300;
+    }
+    s.z += rngNext(50);
+    t->samples.push_back(s);
+    t->truth.push_back(truth);
+    *ms += step;
+  }
+  TouchSample up = {0, 0, 0, false, *ms};
+  t->samples.push_back(up);
+  t->truth.push_back(up);
+  *ms += 200;
+}
+
+static std::vector<Trace> syntheticTraces() {
+  std::vector<Trace> traces;
+  uint32_t ms = 0;
+  const int rate = TOUCH_SAMPLE_RATE;
+
+  Trace tap;
+  tap.name = "tap";
+  tap.maxErrLimit = BENCH_MAX_ERROR;
+  for (int i = 0; i < 10; i++) addSyntheticTouch(&tap, &ms, 1000 + i * 200, 1500, 1000 + i * 200, 1500, rate / 12, 25, 0);
+  traces.push_back(tap);
+
+  Trace hold;
+  hold.name = "hold";
+  hold.maxErrLimit = BENCH_MAX_ERROR;
+  addSyntheticTouch(&hold, &ms, 2000, 2000, 2000, 2000, rate, 25, 0);
+  traces.push_back(hold);
+
+  Trace spikes;
+  spikes.name = "hold_spikes";
+  spikes.maxErrLimit = BENCH_MAX_ERROR;
+  addSyntheticTouch(&spikes, &ms, 2000, 2000, 2000, 2000, rate, 25, 7);
+  traces.push_back(spikes);
+
+  Trace drag;
+  drag.name = "drag";
+  drag.maxErrLimit = BENCH_MAX_ERROR_DRAG;
+  addSyntheticTouch(&drag, &ms, 800, 2000, 3200, 2000, rate / 3, 25, 0);
+  traces.push_back(drag);
+  return traces;
+}
+
+// Lines "touch <ms> <x> <y> <z>" and "touch <ms> up", anywhere in the
+// line so a raw serial capture with other log output works too
+static bool loadTrace(const char *path, Trace *t) {
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  t->name = path;
+  t->maxErrLimit = 0;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    const char *p = strstr(line, "touch ");
+    if (!p) continue;
+    unsigned ms;
+    int x, y, z;
+    char word[8];
+    if (sscanf(p, "touch %u %d %d %d", &ms, &x, &y, &z) == 4) {
+      TouchSample s = {(int16_t)x, (int16_t)y, (int16_t)z, true, ms};
+      t->samples.push_back(s);
+    } else if (sscanf(p, "touch %u %7s", &ms, word) == 2 && strcmp(word, "up") == 0) {
+      TouchSample s = {0, 0, 0, false, ms};
+      t->samples.push_back(s);
+    }
+  }
+  fclose(f);
+  return !t->samples.empty();
+}
+
+struct Quality {
+  uint32_t points;     // Down samples handed to LVGL
+  uint32_t releases;
+  double step;         // Mean distance between consecutive points within a touch
+  double rms;          // Distance to the finger position, synthetic traces only
+  double maxErr;
+};
+
+static double distance(const TouchSample &a, const TouchSample &b) {
+  return hypot((double)a.x - b.x, (double)a.y - b.y);
+}
+
+// Ground truth at a time: the last truth sample at or before it
+static const TouchSample *truthAt(const Trace &t, uint32_t at) {
+  const TouchSample *found = NULL;
+  for (size_t i = 0; i < t.truth.size() && t.truth[i].at <= at; i++) {
+    if (t.truth[i].down) found = &t.truth[i];
+  }
+  return found;
+}
+
+static void measure(const Trace &t, const std::vector<TouchSample> &out, Quality *q) {
+  *q = Quality();
+  double stepSum = 0, errSum = 0;
+  uint32_t steps = 0, errCount = 0;
+  const TouchSample *prev = NULL;
+  for (size_t i = 0; i < out.size(); i++) {
+    if (!out[i].down) {
+      q->releases++;
+      prev = NULL;
+      continue;
+    }
+    q->points++;
+    if (prev) {
+      stepSum += distance(*prev, out[i]);
+      steps++;
+    }
+    prev = &out[i];
+    if (!t.truth.empty()) {
+      const TouchSample *truth = truthAt(t, out[i].at);
+      if (truth) {
+        double err = distance(*truth, out[i]);
+        errSum += err * err;
+        errCount++;
+        if (err > q->maxErr) q->maxErr = err;
+      }
+    }
+  }
+  q->step = steps ? stepSum / steps : 0;
+  q->rms = errCount ? sqrt(errSum / errCount) : 0;
+}
+
+static void runFilter(const Trace &t, TouchFilter *filter, std::vector<TouchSample> *out) {
+  TouchSample produced[2];
+  touchFilterReset(filter);
+  for (size_t i = 0; i < t.samples.size(); i++) {
+    uint8_t count = touchFilterFeed(filter, t.samples[i], produced);
+    for (uint8_t j = 0; j < count; j++) out->push_back(produced[j]);
+  }
+}
+
+int main(int argc, char **argv) {
+  int iterations = BENCH_ITERATIONS_DEFAULT;
+  std::vector<Trace> traces = syntheticTraces();
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = atoi(argv[++i]);
+    } else {
+      Trace t;
+      if (!loadTrace(argv[i], &t)) {
+        fprintf(stderr, "No touch samples in %s\n", argv[i]);
+        return 1;
+      }
+      traces.push_back(t);
+    }
+  }
+
+  printf("# pressure_min=%d oversample=%d median=%d iir_alpha=%d/256\n", TOUCH_PRESSURE_MIN,
+         TOUCH_OVERSAMPLE, TOUCH_MEDIAN_SIZE, TOUCH_IIR_ALPHA);
+  printf("trace,samples,raw_points,points,rejected,raw_step,step,raw_rms,rms,raw_max,max,ns_per_sample\n");
+
+  int failures = 0;
+  for (size_t n = 0; n < traces.size(); n++) {
+    const Trace &t = traces[n];
+
+    // Unfiltered: every sample goes to LVGL as it is
+    Quality raw;
+    measure(t, t.samples, &raw);
+
+    TouchFilter filter = {};
+    std::vector<TouchSample> out;
+    runFilter(t, &filter, &out);
+    Quality filtered;
+    measure(t, out, &filtered);
+    uint32_t rejected = filter.rejected;
+
+    // Timing over the whole trace, the output goes to a volatile so the
+    // loop stays
+    TouchSample produced[2];
+    volatile int32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; it++) {
+      touchFilterReset(&filter);
+      for (size_t i = 0; i < t.samples.size(); i++) {
+        uint8_t count = touchFilterFeed(&filter, t.samples[i], produced);
+        if (count) sink = sink + produced[0].x;
+      }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() /
+                ((double)iterations * t.samples.size());
+
+    if (t.truth.empty()) {
+      printf("%s,%u,%u,%u,%u,%.1f,%.1f,-,-,-,-,%.1f\n", t.name.c_str(), (unsigned)t.samples.size(),
+             (unsigned)raw.points, (unsigned)filtered.points, (unsigned)rejected, raw.step, filtered.step, ns);
+    } else {
+      printf("%s,%u,%u,%u,%u,%.1f,%.1f,%.1f,%.1f,%.0f,%.0f,%.1f\n", t.name.c_str(),
+             (unsigned)t.samples.size(), (unsigned)raw.points, (unsigned)filtered.points, (unsigned)rejected,
+             raw.step, filtered.step, raw.rms, filtered.rms, raw.maxErr, filtered.maxErr, ns);
+    }
+    if (filtered.releases != raw.releases) {
+      printf("# FAIL %s: %u touches in, %u releases out\n", t.name.c_str(), (unsigned)raw.releases,
+             (unsigned)filtered.releases);
+      failures++;
+    }
+    if (!t.truth.empty() && filtered.maxErr > t.maxErrLimit) {
+      printf("# FAIL %s: max error %.0f over the limit of %.0f\n", t.name.c_str(), filtered.maxErr,
+             t.maxErrLimit);
+      failures++;
+    }
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,222 @@
+/*
+ * UI frame-time benchmark for the AC controller screens
+ * Runs the sketch in test mode and drives each screen transition and
+ * modal through its event callbacks. For every scenario it reports the
+ * time to handle the event and render the result, the invalidated area,
+ * the number of flush calls and the LVGL heap use.
+ *
+ * Output is CSV on stdout so runs can be diffed or plotted:
+ *   scenario,runs,avg_us,max_us,inv_px,flushes,flush_px,heap_used,heap_peak
+ */
+
+#include <Arduino.h>
+#include "../src/ac_controller_lvgl.h"
+#include "../config/hardware_config.h"
+
+void setup();
+void loop();
+
+#define BENCH_RUNS_DEFAULT 20
+
+// Area invalidated since the last reset, summed over LV_EVENT_INVALIDATE_AREA
+// (overlapping areas are counted twice, LVGL joins them before rendering)
+static uint32_t invalidatedPixels = 0;
+static size_t heapPeak = 0;
+
+static void invalidate_area_cb(lv_event_t *e) {
+  const lv_area_t *area = (const lv_area_t *)lv_event_get_param(e);
+  if (area) invalidatedPixels += lv_area_get_size(area);
+}
+
+static size_t heapUsed() {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  return mon.total_size - mon.free_size;
+}
+
+static void sampleHeap() {
+  size_t used = heapUsed();
+  if (used > heapPeak) heapPeak = used;
+}
+
+// One pass of loop() without its idle wait
+static void loopOnce() {
+  xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+  loop();
+}
+
+// Render everything that is pending and wait for the last transfer, then
+// let loop() hand the DMA buffer back to LVGL
+static void renderNow() {
+  lv_refr_now(NULL);
+  tft.dmaWait();
+}
+
+static void settle() {
+  renderNow();
+  loopOnce();
+}
+
+static void click(lv_obj_t *obj) {
+  lv_obj_send_event(obj, LV_EVENT_CLICKED, NULL);
+}
+
+// Same as the modal's close button
+static void closeTopModal() {
+  hideUnitModals();
+}
+
+// Message boxes live on the top layer inside their backdrop
+static void closeMsgbox() {
+  lv_obj_t *top = lv_layer_top();
+  uint32_t count = lv_obj_get_child_count(top);
+  if (count == 0) return;
+  lv_obj_t *backdrop = lv_obj_get_child(top, count - 1);
+  lv_obj_t *mbox = lv_obj_get_child(backdrop, 0);
+  if (mbox) lv_msgbox_close(mbox);
+  else lv_obj_delete(backdrop);
+}
+
+static void openUnitScreen() {
+  click(unitCards[0]);
+}
+
+static void backToMain() {
+  click(backButton);
+}
+
+// The open callbacks only look at selectedUnit, not at the event
+static void openModeModal() { mode_button_modal_event_cb(NULL); }
+static void openFanModal() { fan_button_event_cb(NULL); }
+static void openSwingModal() { swing_button_event_cb(NULL); }
+static void openAllOnMsgbox() { all_on_event_cb(NULL); }
+static void openAllOffMsgbox() { all_off_event_cb(NULL); }
+static void nextPage() { click(nextButton); }
+static void prevPage() { click(prevButton); }
+
+struct Scenario {
+  const char *name;
+  void (*prepare)();  // Brings the UI into the start state, not timed
+  void (*action)();   // Timed together with the render that follows
+  void (*cleanup)();  // Undoes the action, not timed
+};
+
+static void onMain() {
+  if (lv_screen_active() != mainScreen) backToMain();
+}
+
+static void onUnit() {
+  if (lv_screen_active() != unitScreen) openUnitScreen();
+  acUnits[selectedUnit].isOn = true; // The fan modal only opens for a running unit
+}
+
+static void onMainSecondPage() {
+  onMain();
+  if (currentPage == 0) nextPage();
+}
+
+static void onUnitModeModal() { onUnit(); openModeModal(); }
+static void onUnitFanModal() { onUnit(); openFanModal(); }
+static void onUnitSwingModal() { onUnit(); openSwingModal(); }
+
+static void nothing() {}
+
+static const Scenario scenarios[] = {
+  {"main_next_page",   onMain, nextPage,         prevPage},
+  {"main_prev_page",   onMainSecondPage, prevPage, nothing},
+  {"card_to_unit",     onMain, openUnitScreen,   backToMain},
+  {"unit_to_main",     onUnit, backToMain,       nothing},
+  {"mode_modal_open",  onUnit, openModeModal,    closeTopModal},
+  {"mode_modal_close", onUnitModeModal, closeTopModal, nothing},
+  {"fan_modal_open",   onUnit, openFanModal,     closeTopModal},
+  {"fan_modal_close",  onUnitFanModal, closeTopModal, nothing},
+  {"swing_modal_open", onUnit, openSwingModal,   closeTopModal},
+  {"swing_modal_close", onUnitSwingModal, closeTopModal, nothing},
+  {"all_on_msgbox",    onMain, openAllOnMsgbox,  closeMsgbox},
+  {"all_off_msgbox",   onMain, openAllOffMsgbox, closeMsgbox},
+};
+
+static void runScenario(const Scenario &s, uint32_t runs) {
+  uint64_t totalMicros = 0;
+  uint32_t maxMicros = 0;
+  uint64_t totalInvalidated = 0;
+  uint64_t totalFlushes = 0;
+  uint64_t totalFlushPixels = 0;
+  size_t heapUsedAfter = 0;
+  heapPeak = 0;
+
+  for (uint32_t r = 0; r < runs; r++) {
+    s.prepare();
+    settle();
+
+    invalidatedPixels = 0;
+    tft.resetStats();
+    sampleHeap();
+
+    uint32_t start = micros();
+    s.action();
+    sampleHeap();
+    renderNow();
+    uint32_t elapsed = micros() - start;
+    sampleHeap();
+
+    totalMicros += elapsed;
+    if (elapsed > maxMicros) maxMicros = elapsed;
+    totalInvalidated += invalidatedPixels;
+    totalFlushes += tft.stats.transfers;
+    totalFlushPixels += tft.stats.bytes / 2;
+    heapUsedAfter = heapUsed();
+
+    loopOnce();
+    s.cleanup();
+    settle();
+  }
+
+  printf("%s,%u,%llu,%u,%llu,%llu,%llu,%u,%u\n", s.name, runs,
+         (unsigned long long)(totalMicros / runs), maxMicros,
+         (unsigned long long)(totalInvalidated / runs),
+         (unsigned long long)(totalFlushes / runs),
+         (unsigned long long)(totalFlushPixels / runs),
+         (unsigned)heapUsedAfter, (unsigned)heapPeak);
+}
+
+int main(int argc, char **argv) {
+  uint32_t runs = BENCH_RUNS_DEFAULT;
+  const char *only = NULL;
+
+  bool verbose = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--verbose") == 0) {
+      verbose = true;
+    } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+      runs = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+      only = argv[++i];
+    } else {
+      fprintf(stderr, "Usage: %s [--runs N] [--scenario NAME] [--verbose]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (runs == 0) runs = 1;
+
+  // Keep the sketch's Serial output out of the CSV unless asked for
+  if (!verbose) hostSerialOut = fopen("/dev/null", "w");
+
+  testMode = true;
+  setup();
+  lv_display_add_event_cb(lv_display_get_default(), invalidate_area_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+  settle();
+
+  printf("scenario,runs,avg_us,max_us,inv_px,flushes,flush_px,heap_used,heap_peak\n");
+  for (const Scenario &s : scenarios) {
+    if (only && strcmp(only, s.name) != 0) continue;
+    runScenario(s, runs);
+  }
+
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  printf("# LVGL heap: %u total, %u high-water, %u%% fragmented\n",
+         (unsigned)mon.total_size, (unsigned)mon.max_used, mon.frag_pct);
+  return 0;
+}
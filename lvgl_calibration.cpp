@@ -0,0 +1,119 @@
+#include <lvgl.h>
+#include "src/ac_controller_lvgl.h"
+
+// Touch calibration screen. Three targets give the affine transform
+// (src/touch_calibration.h), a fourth one in the middle checks it before
+// it is used and saved. Opened from the diagnostics screen, or by
+// keeping a finger on the screen while the controller starts.
+
+#define CAL_MARGIN 24     // Distance of the outer targets to the screen edge in pixels
+#define CAL_CROSS_SIZE 21
+#define CAL_STEPS 4
+
+static const TouchCalPoint calTargets[CAL_STEPS] = {
+  {CAL_MARGIN, CAL_MARGIN},
+  {TFT_WIDTH - CAL_MARGIN, TFT_HEIGHT / 2},
+  {TFT_WIDTH / 2, TFT_HEIGHT - CAL_MARGIN},
+  {TFT_WIDTH / 2, TFT_HEIGHT / 2}, // Check only
+};
+
+static lv_obj_t *calCross = NULL;
+static lv_obj_t *calLabel = NULL;
+static uint8_t calStep = 0;
+static bool calPressed = false; // A press started on this screen, not before it was shown
+static TouchCalPoint calRaw[CAL_STEPS];
+static TouchCalibration calResult;
+
+static void showCalibrationStep(uint8_t step, const char *message) {
+  calStep = step;
+  lv_obj_set_pos(calCross, calTargets[step].x - CAL_CROSS_SIZE / 2, calTargets[step].y - CAL_CROSS_SIZE / 2);
+  if (step < CAL_STEPS - 1) {
+    lv_label_set_text_fmt(calLabel, "%sTik op het kruis (%u/3)", message, (unsigned)(step + 1));
+  } else {
+    lv_label_set_text_fmt(calLabel, "%sTik ter controle op het kruis", message);
+  }
+}
+
+static void finishCalibration() {
+  int32_t x, y;
+  touchCalibrationApply(&calResult, calRaw[3].x, calRaw[3].y, &x, &y);
+  int32_t dx = x - calTargets[3].x;
+  int32_t dy = y - calTargets[3].y;
+  LOG_INFO("Touch calibration check: off by %d,%d px\n", (int)dx, (int)dy);
+  if (dx * dx + dy * dy > TOUCH_CAL_TOLERANCE * TOUCH_CAL_TOLERANCE) {
+    showCalibrationStep(0, "Niet nauwkeurig genoeg.\n");
+    return;
+  }
+
+  touchCalibration = calResult;
+  if (!saveTouchCalibration(&calResult)) {
+    LOG_ERROR("ERROR: Saving touch calibration failed\n");
+  }
+  lv_scr_load(mainScreen);
+  updateMainScreen();
+}
+
+// A target counts when the finger lifts, using the last filtered point
+// of the press in raw controller coordinates
+static void calibration_event_cb(lv_event_t *e) {
+  if (lv_event_get_code(e) == LV_EVENT_PRESSED) {
+    calPressed = true;
+    return;
+  }
+  if (!calPressed) return;
+  calPressed = false;
+
+  calRaw[calStep] = touchLastRaw;
+  LOG_DEBUG("Touch calibration point %u: raw %d,%d\n", (unsigned)calStep, touchLastRaw.x, touchLastRaw.y);
+
+  if (calStep == 2) {
+    if (!touchCalibrationCompute(calRaw, calTargets, &calResult)) {
+      showCalibrationStep(0, "Mislukt, opnieuw.\n");
+      return;
+    }
+  } else if (calStep == CAL_STEPS - 1) {
+    finishCalibration();
+    return;
+  }
+  showCalibrationStep(calStep + 1, "");
+}
+
+static void createCalibrationScreen() {
+  calibrationScreen = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(calibrationScreen, lv_color_hex(0x1a2639), LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_clear_flag(calibrationScreen, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_event_cb(calibrationScreen, calibration_event_cb, LV_EVENT_PRESSED, NULL);
+  lv_obj_add_event_cb(calibrationScreen, calibration_event_cb, LV_EVENT_RELEASED, NULL);
+
+  // Cross hair, the children are not clickable so every touch ends up
+  // at the screen itself
+  calCross = lv_obj_create(calibrationScreen);
+  lv_obj_set_size(calCross, CAL_CROSS_SIZE, CAL_CROSS_SIZE);
+  lv_obj_set_style_bg_opa(calCross, LV_OPA_TRANSP, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_border_width(calCross, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_pad_all(calCross, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_clear_flag(calCross, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+  for (uint8_t i = 0; i < 2; i++) {
+    lv_obj_t *line = lv_obj_create(calCross);
+    lv_obj_set_size(line, i == 0 ? CAL_CROSS_SIZE : 1, i == 0 ? 1 : CAL_CROSS_SIZE);
+    lv_obj_center(line);
+    lv_obj_set_style_bg_color(line, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(line, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_radius(line, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_clear_flag(line, LV_OBJ_FLAG_CLICKABLE);
+  }
+
+  calLabel = lv_label_create(calibrationScreen);
+  lv_obj_set_width(calLabel, TFT_WIDTH - 2 * CAL_MARGIN);
+  lv_obj_align(calLabel, LV_ALIGN_CENTER, 0, -50);
+  lv_obj_set_style_text_align(calLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_text_font(calLabel, &lv_font_montserrat_12, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_text_color(calLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+}
+
+void showCalibrationScreen() {
+  if (!calibrationScreen) createCalibrationScreen();
+  calPressed = false;
+  showCalibrationStep(0, "");
+  lv_scr_load(calibrationScreen);
+}
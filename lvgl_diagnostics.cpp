@@ -0,0 +1,175 @@
+#include <lvgl.h>
+#include "src/ac_controller_lvgl.h"
+
+// Diagnostics screen: command to confirmation latency per unit, and the
+// way into touch calibration. Opened with a long press on the main
+// screen title. It is only created the first time it is opened and
+// refreshed once a second while shown.
+
+#define DIAGNOSTICS_REFRESH_INTERVAL 1000
+
+static lv_obj_t *latencyChart = NULL;
+static lv_chart_series_t *latencySeries = NULL;
+static lv_obj_t *latencyTable = NULL;
+static lv_obj_t *latencySummary = NULL;
+static lv_timer_t *diagnosticsTimer = NULL;
+
+// Bucket limit as shown in the table, "<256" or ">8192"
+static void formatLatencyBucket(char *buf, size_t size, int bucket) {
+  if (bucket < 0) snprintf(buf, size, "-");
+  else if (bucket < LATENCY_BUCKETS - 1) snprintf(buf, size, "<%u", (unsigned)latencyBucketLimit(bucket));
+  else snprintf(buf, size, ">%u", (unsigned)latencyBucketLimit(bucket - 1));
+}
+
+static void refreshDiagnosticsScreen() {
+  LatencyHistogram total = {};
+  char buf[16];
+
+  for (int i = 0; i < numUnits; i++) {
+    const LatencyHistogram *h = &unitLatency[i];
+    latencyMerge(&total, h);
+    snprintf(buf, sizeof(buf), "%u", (unsigned)h->samples);
+    lv_table_set_cell_value(latencyTable, i + 1, 1, buf);
+    formatLatencyBucket(buf, sizeof(buf), latencyPercentileBucket(h, 50));
+    lv_table_set_cell_value(latencyTable, i + 1, 2, buf);
+    formatLatencyBucket(buf, sizeof(buf), latencyPercentileBucket(h, 90));
+    lv_table_set_cell_value(latencyTable, i + 1, 3, buf);
+    snprintf(buf, sizeof(buf), "%u", (unsigned)h->maxMs);
+    lv_table_set_cell_value(latencyTable, i + 1, 4, buf);
+  }
+
+  uint16_t highest = 1;
+  for (uint8_t b = 0; b < LATENCY_BUCKETS; b++) {
+    lv_chart_set_value_by_id(latencyChart, latencySeries, b, total.counts[b]);
+    if (total.counts[b] > highest) highest = total.counts[b];
+  }
+  lv_chart_set_range(latencyChart, LV_CHART_AXIS_PRIMARY_Y, 0, highest);
+  lv_chart_refresh(latencyChart);
+
+  lv_label_set_text_fmt(latencySummary, "%u bevestigd, %u time-out, gem. %u ms",
+                        (unsigned)commandStats.confirmed, (unsigned)commandStats.timedOut,
+                        (unsigned)(total.samples ? total.sumMs / total.samples : 0));
+}
+
+static void diagnostics_timer_cb(lv_timer_t *timer) {
+  refreshDiagnosticsScreen();
+}
+
+static void stopDiagnosticsTimer() {
+  if (diagnosticsTimer) {
+    lv_timer_delete(diagnosticsTimer);
+    diagnosticsTimer = NULL;
+  }
+}
+
+static void diagnostics_back_event_cb(lv_event_t *e) {
+  stopDiagnosticsTimer();
+  lv_scr_load(mainScreen);
+  updateMainScreen();
+}
+
+static void diagnostics_calibrate_event_cb(lv_event_t *e) {
+  stopDiagnosticsTimer();
+  showCalibrationScreen();
+}
+
+static void diagnostics_dump_event_cb(lv_event_t *e) {
+  printLatencyHistograms();
+}
+
+static void createDiagnosticsScreen() {
+  diagnosticsScreen = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(diagnosticsScreen, lv_color_hex(0x1a2639), LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_clear_flag(diagnosticsScreen, LV_OBJ_FLAG_SCROLLABLE);
+
+  // Header with back button and title, like the unit screen
+  lv_obj_t *header = lv_obj_create(diagnosticsScreen);
+  lv_obj_set_size(header, lv_pct(100), 35);
+  lv_obj_align(header, LV_ALIGN_TOP_MID, 0, 0);
+  lv_obj_set_style_bg_color(header, lv_color_hex(0x364156), LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_border_width(header, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_radius(header, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_clear_flag(header, LV_OBJ_FLAG_SCROLLABLE);
+
+  lv_obj_t *backBtn = lv_btn_create(header);
+  lv_obj_set_size(backBtn, 30, 25);
+  lv_obj_align(backBtn, LV_ALIGN_LEFT_MID, -5, 0);
+  lv_obj_set_style_bg_color(backBtn, lv_color_hex(0x1a2639), LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_add_event_cb(backBtn, diagnostics_back_event_cb, LV_EVENT_CLICKED, NULL);
+  lv_obj_t *backLabel = lv_label_create(backBtn);
+  lv_label_set_text(backLabel, LV_SYMBOL_LEFT);
+  lv_obj_center(backLabel);
+
+  lv_obj_t *title = lv_label_create(header);
+  lv_label_set_text(title, "Commando latentie");
+  lv_obj_center(title);
+  lv_obj_set_style_text_font(title, &lv_font_montserrat_12, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_text_color(title, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+  // All units histogram, one bar per bucket
+  latencyChart = lv_chart_create(diagnosticsScreen);
+  lv_obj_set_size(latencyChart, 220, 80);
+  lv_obj_align(latencyChart, LV_ALIGN_TOP_MID, 0, 40);
+  lv_chart_set_type(latencyChart, LV_CHART_TYPE_BAR);
+  lv_chart_set_point_count(latencyChart, LATENCY_BUCKETS);
+  lv_chart_set_div_line_count(latencyChart, 0, 0);
+  lv_obj_set_style_bg_color(latencyChart, lv_color_hex(0x364156), LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_border_width(latencyChart, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+  latencySeries = lv_chart_add_series(latencyChart, lv_color_hex(0x3FC1C9), LV_CHART_AXIS_PRIMARY_Y);
+
+  lv_obj_t *axisLabel = lv_label_create(diagnosticsScreen);
+  lv_label_set_text_fmt(axisLabel, "<%u ms  ...  >%u ms (log)", (unsigned)LATENCY_FIRST_BUCKET_MS,
+                        (unsigned)latencyBucketLimit(LATENCY_BUCKETS - 2));
+  lv_obj_align(axisLabel, LV_ALIGN_TOP_MID, 0, 122);
+  lv_obj_set_style_text_font(axisLabel, &lv_font_montserrat_12, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_text_color(axisLabel, lv_color_hex(0xAAAAAA), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+  // Per unit table: samples, median and 90th percentile bucket, maximum
+  latencyTable = lv_table_create(diagnosticsScreen);
+  lv_obj_set_size(latencyTable, 230, 125);
+  lv_obj_align(latencyTable, LV_ALIGN_TOP_MID, 0, 140);
+  lv_table_set_column_count(latencyTable, 5);
+  lv_table_set_row_count(latencyTable, numUnits + 1);
+  const uint16_t widths[] = {70, 30, 42, 42, 42};
+  const char *headings[] = {"Unit", "n", "p50", "p90", "max"};
+  for (uint8_t c = 0; c < 5; c++) {
+    lv_table_set_column_width(latencyTable, c, widths[c]);
+    lv_table_set_cell_value(latencyTable, 0, c, headings[c]);
+  }
+  for (int i = 0; i < numUnits; i++) {
+    lv_table_set_cell_value(latencyTable, i + 1, 0, acUnits[i].name);
+  }
+  lv_obj_set_style_text_font(latencyTable, &lv_font_montserrat_12, LV_PART_ITEMS | LV_STATE_DEFAULT);
+  lv_obj_set_style_pad_all(latencyTable, 3, LV_PART_ITEMS | LV_STATE_DEFAULT);
+
+  latencySummary = lv_label_create(diagnosticsScreen);
+  lv_obj_align(latencySummary, LV_ALIGN_TOP_LEFT, 5, 272);
+  lv_obj_set_style_text_font(latencySummary, &lv_font_montserrat_12, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_text_color(latencySummary, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+  // Dump the same numbers over serial, with all buckets
+  lv_obj_t *dumpBtn = lv_btn_create(diagnosticsScreen);
+  lv_obj_set_size(dumpBtn, 100, 25);
+  lv_obj_align(dumpBtn, LV_ALIGN_BOTTOM_LEFT, 10, -3);
+  lv_obj_set_style_bg_color(dumpBtn, lv_color_hex(0x364156), LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_add_event_cb(dumpBtn, diagnostics_dump_event_cb, LV_EVENT_CLICKED, NULL);
+  lv_obj_t *dumpLabel = lv_label_create(dumpBtn);
+  lv_label_set_text(dumpLabel, "Serial dump");
+  lv_obj_center(dumpLabel);
+
+  lv_obj_t *calibrateBtn = lv_btn_create(diagnosticsScreen);
+  lv_obj_set_size(calibrateBtn, 100, 25);
+  lv_obj_align(calibrateBtn, LV_ALIGN_BOTTOM_RIGHT, -10, -3);
+  lv_obj_set_style_bg_color(calibrateBtn, lv_color_hex(0x364156), LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_add_event_cb(calibrateBtn, diagnostics_calibrate_event_cb, LV_EVENT_CLICKED, NULL);
+  lv_obj_t *calibrateLabel = lv_label_create(calibrateBtn);
+  lv_label_set_text(calibrateLabel, "Kalibreren");
+  lv_obj_center(calibrateLabel);
+}
+
+void showDiagnosticsScreen() {
+  if (!diagnosticsScreen) createDiagnosticsScreen();
+  refreshDiagnosticsScreen();
+  if (!diagnosticsTimer) diagnosticsTimer = lv_timer_create(diagnostics_timer_cb, DIAGNOSTICS_REFRESH_INTERVAL, NULL);
+  lv_scr_load(diagnosticsScreen);
+}
@@ -95,7 +95,7 @@ void all_on_msgbox_event_cb(lv_event_t *e) {
     lv_obj_center(notification);
     
     lv_obj_t *notifLabel = lv_label_create(notification);
-    lv_label_set_text(notifLabel, "All units turned ON");
+    lv_label_set_text(notifLabel, "Sending ON to all units...");
     lv_obj_center(notifLabel);
     
     // Return to main screen
@@ -156,7 +156,7 @@ void all_off_msgbox_event_cb(lv_event_t *e) {
     lv_obj_center(notification);
     
     lv_obj_t *notifLabel = lv_label_create(notification);
-    lv_label_set_text(notifLabel, "All units turned OFF");
+    lv_label_set_text(notifLabel, "Sending OFF to all units...");
     lv_obj_center(notifLabel);
     
     // Return to main screen
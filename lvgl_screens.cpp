@@ -1,5 +1,152 @@
 #include <lvgl.h>
 #include "src/ac_controller_lvgl.h"
+#include "config/ui_config.h"
+
+// Persistent card widgets, created once in createMainScreen
+static lv_obj_t *cardNameLabels[4];
+static lv_obj_t *cardTempLabels[4];
+static lv_obj_t *cardStatusIndicators[4];
+
+// Last rendered values per card, used to skip unchanged widgets
+struct CardSnapshot {
+  int unitIndex;      // Unit shown on this card, -1 when hidden
+  float currentTemp;
+  bool isOn;
+  uint8_t mode;
+  bool highlighted;   // Card background was changed by a click
+  bool busy;          // Card is dimmed while commands for its unit are queued
+};
+static CardSnapshot cardSnapshots[4];
+
+// Widgets a card refresh is meant for; a requested widget whose snapshot
+// still matches counts as a redraw avoided
+#define CARD_WIDGET_TEMP   (1 << 0)
+#define CARD_WIDGET_STATUS (1 << 1)
+#define CARD_WIDGET_BUSY   (1 << 2)
+
+// Number of widget updates skipped because nothing changed
+uint32_t cardRedrawsAvoided = 0;
+
+// Unit each card observes, -1 when the card is unbound
+static int cardBoundUnit[4] = {-1, -1, -1, -1};
+static lv_observer_t *cardObservers[4][3];
+static bool cardBinding = false; // Adding observers notifies them, that is no refresh
+
+// Connection state shown by the header icons, -1 until first render
+static int renderedWifiState = -1;
+static int renderedMqttState = -1;
+
+// Set the status indicator colors for a unit's power state and mode
+static void applyStatusIndicatorStyle(lv_obj_t *statusIndicator, bool isOn, uint8_t mode) {
+  if (isOn) {
+    // Unit is on - show color based on mode
+    lv_color_t color = ui_get_mode_color(mode);
+    lv_obj_set_style_bg_color(statusIndicator, color, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_color(statusIndicator, color, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(statusIndicator, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+  } else {
+    // Unit is off - show outline only
+    lv_obj_set_style_bg_opa(statusIndicator, LV_OPA_TRANSP, LV_PART_MAIN | LV_STATE_DEFAULT); // Transparent background
+    lv_obj_set_style_border_color(statusIndicator, lv_color_hex(0xAAAAAA), LV_PART_MAIN | LV_STATE_DEFAULT); // Light grey border
+  }
+}
+
+// Bring one card in line with a unit, skipping widgets that are already
+// up to date. `requested` holds the CARD_WIDGET_* the caller expects to change.
+static void updateUnitCard(int cardIndex, int unitIndex, uint8_t requested) {
+  lv_obj_t *card = unitCards[cardIndex];
+  CardSnapshot *snap = &cardSnapshots[cardIndex];
+  ACUnit *unit = &acUnits[unitIndex];
+  bool newUnit = (snap->unitIndex != unitIndex);
+  if (snap->unitIndex == -1) {
+    lv_obj_clear_flag(card, LV_OBJ_FLAG_HIDDEN);
+  }
+  
+  if (newUnit) {
+    // Store unit index in user data
+    lv_obj_set_user_data(card, (void*)(intptr_t)unitIndex);
+    lv_label_set_text_static(cardNameLabels[cardIndex], unit->name);
+  }
+  
+  bool tempUnknown = isnan(unit->currentTemp);
+  if (newUnit || (tempUnknown ? !isnan(snap->currentTemp) : snap->currentTemp != unit->currentTemp)) {
+    char tempStr[10];
+    if (tempUnknown) strcpy(tempStr, "--.-°C");
+    else sprintf(tempStr, "%.1f°C", unit->currentTemp);
+    lv_label_set_text(cardTempLabels[cardIndex], tempStr);
+    snap->currentTemp = unit->currentTemp;
+  } else if (requested & CARD_WIDGET_TEMP) {
+    cardRedrawsAvoided++;
+  }
+  
+  // Mode only affects the indicator while the unit is on
+  bool statusChanged = newUnit || snap->isOn != unit->isOn ||
+                       (unit->isOn && snap->mode != unit->mode);
+  if (statusChanged) {
+    applyStatusIndicatorStyle(cardStatusIndicators[cardIndex], unit->isOn, unit->mode);
+    snap->isOn = unit->isOn;
+    snap->mode = unit->mode;
+  } else if (requested & CARD_WIDGET_STATUS) {
+    cardRedrawsAvoided++;
+  }
+  
+  bool busy = unitHasQueuedCommands(unitIndex);
+  if (newUnit || snap->busy != busy) {
+    lv_obj_set_style_opa(card, busy ? LV_OPA_50 : LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+    snap->busy = busy;
+  } else if (requested & CARD_WIDGET_BUSY) {
+    cardRedrawsAvoided++;
+  }
+  
+  snap->unitIndex = unitIndex;
+}
+
+// Called by LVGL when a field shown on a card changes
+static void card_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+  int cardIndex = (int)(intptr_t)lv_observer_get_user_data(observer);
+  int unitIndex = cardBoundUnit[cardIndex];
+  if (unitIndex < 0) return;
+  uint8_t requested = 0;
+  if (!cardBinding) {
+    requested = subject == &acUnits[unitIndex].subjects[AC_FIELD_CURRENT_TEMP] ? CARD_WIDGET_TEMP : CARD_WIDGET_STATUS;
+  }
+  updateUnitCard(cardIndex, unitIndex, requested);
+}
+
+// Stop a card from following its unit's subjects
+static void unbindUnitCard(int cardIndex) {
+  if (cardBoundUnit[cardIndex] < 0) return;
+  for (int f = 0; f < 3; f++) {
+    lv_observer_remove(cardObservers[cardIndex][f]);
+    cardObservers[cardIndex][f] = NULL;
+  }
+  cardBoundUnit[cardIndex] = -1;
+}
+
+// Make a card follow a unit's temperature, power and mode subjects
+static void bindUnitCard(int cardIndex, int unitIndex) {
+  if (cardBoundUnit[cardIndex] == unitIndex) return;
+  unbindUnitCard(cardIndex);
+  cardBoundUnit[cardIndex] = unitIndex;
+  
+  // Adding an observer notifies it once, which renders the card for the new unit
+  ACUnit *unit = &acUnits[unitIndex];
+  void *userData = (void*)(intptr_t)cardIndex;
+  cardBinding = true;
+  cardObservers[cardIndex][0] = lv_subject_add_observer(&unit->subjects[AC_FIELD_CURRENT_TEMP], card_observer_cb, userData);
+  cardObservers[cardIndex][1] = lv_subject_add_observer(&unit->subjects[AC_FIELD_POWER], card_observer_cb, userData);
+  cardObservers[cardIndex][2] = lv_subject_add_observer(&unit->subjects[AC_FIELD_MODE], card_observer_cb, userData);
+  cardBinding = false;
+}
+
+// Dim or restore the card of a unit when its queued commands change
+void showUnitCommandProgress(int unitIndex) {
+  for (int i = 0; i < 4; i++) {
+    if (cardBoundUnit[i] == unitIndex) {
+      updateUnitCard(i, unitIndex, CARD_WIDGET_BUSY);
+    }
+  }
+}
 
 // Create the loading screen
 void createLoadingScreen() {
@@ -20,6 +167,10 @@ void createLoadingScreen() {
   lv_obj_set_style_text_font(label, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
 }
 
+static void title_long_press_event_cb(lv_event_t *e) {
+  showDiagnosticsScreen();
+}
+
 // Create the main screen with unit cards and pagination
 void createMainScreen() {
   // Create main screen for 240x320 portrait layout
@@ -44,6 +195,9 @@ void createMainScreen() {
   lv_obj_align(mainTitle, LV_ALIGN_LEFT_MID, 5, 0);
   lv_obj_set_style_text_font(mainTitle, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
   lv_obj_set_style_text_color(mainTitle, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+  // Long press on the title opens the diagnostics screen
+  lv_obj_add_flag(mainTitle, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_add_event_cb(mainTitle, title_long_press_event_cb, LV_EVENT_LONG_PRESSED, NULL);
   
   // Create status icons container - right-aligned
   lv_obj_t *statusIcons = lv_obj_create(headerArea);
@@ -119,6 +273,34 @@ void createMainScreen() {
     lv_obj_add_event_cb(unitCards[i], unit_card_event_cb, LV_EVENT_CLICKED, NULL);
     lv_obj_add_event_cb(unitCards[i], unit_card_event_cb, LV_EVENT_PRESSED, NULL);
     
+    // Card widgets are created once here and only updated in updateMainScreen
+    // Unit name - left side with proper spacing
+    cardNameLabels[i] = lv_label_create(unitCards[i]);
+    lv_label_set_text(cardNameLabels[i], "");
+    lv_obj_align(cardNameLabels[i], LV_ALIGN_LEFT_MID, 8, 0);
+    lv_obj_set_style_text_font(cardNameLabels[i], &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(cardNameLabels[i], lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_width(cardNameLabels[i], 130); // Adequate width for unit names
+    lv_label_set_long_mode(cardNameLabels[i], LV_LABEL_LONG_DOT); // Truncate with dots if too long
+    
+    // Current temperature - center right
+    cardTempLabels[i] = lv_label_create(unitCards[i]);
+    lv_label_set_text(cardTempLabels[i], "");
+    lv_obj_align(cardTempLabels[i], LV_ALIGN_RIGHT_MID, -30, 0);
+    lv_obj_set_style_text_font(cardTempLabels[i], &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(cardTempLabels[i], lv_color_hex(0x3FC1C9), LV_PART_MAIN | LV_STATE_DEFAULT);
+    
+    // Status indicator - right side with proper spacing
+    cardStatusIndicators[i] = lv_obj_create(unitCards[i]);
+    lv_obj_set_size(cardStatusIndicators[i], 16, 16);
+    lv_obj_align(cardStatusIndicators[i], LV_ALIGN_RIGHT_MID, -8, 0);
+    lv_obj_set_style_radius(cardStatusIndicators[i], 8, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(cardStatusIndicators[i], 2, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_clear_flag(cardStatusIndicators[i], LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(cardStatusIndicators[i], LV_OBJ_FLAG_CLICKABLE); // Let clicks reach the card
+    
+    cardSnapshots[i].unitIndex = -1; // Nothing rendered yet
+    
     // Initially hide cards
     lv_obj_add_flag(unitCards[i], LV_OBJ_FLAG_HIDDEN);
   }
@@ -177,132 +359,87 @@ void createMainScreen() {
   lv_obj_set_style_text_color(pageIndicator, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
 }
 
-// Update the main screen with current data
-void updateMainScreen() {
-  // Update status icons
+// Update the header status icons, only when the connection state changed
+void updateStatusIcons() {
+  int wifiState = (WiFi.status() == WL_CONNECTED) ? 1 : 0;
+  // 0 = disconnected or backing off, 1 = connected, 2 = connecting or subscribing
+  int mqttState = 0;
+  MqttLinkState link = mqttLinkState;
+  if (wifiState && (link == MQTT_LINK_CONNECTING || link == MQTT_LINK_SUBSCRIBING)) {
+    mqttState = 2;
+  } else if (wifiState && mqttConnected) {
+    mqttState = 1;
+  }
   
   // Test mode icon
-  if (testMode) {
-    lv_obj_clear_flag(testModeIcon, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_set_style_text_color(testModeIcon, lv_color_hex(0xFFAA00), LV_PART_MAIN | LV_STATE_DEFAULT);
-  } else {
-    lv_obj_add_flag(testModeIcon, LV_OBJ_FLAG_HIDDEN);
+  if (renderedWifiState == -1) {
+    if (testMode) {
+      lv_obj_clear_flag(testModeIcon, LV_OBJ_FLAG_HIDDEN);
+      lv_obj_set_style_text_color(testModeIcon, lv_color_hex(0xFFAA00), LV_PART_MAIN | LV_STATE_DEFAULT);
+    } else {
+      lv_obj_add_flag(testModeIcon, LV_OBJ_FLAG_HIDDEN);
+    }
   }
   
   // MQTT connection icon
-  if (WiFi.status() == WL_CONNECTED && mqttClient.connected()) {
-    lv_obj_clear_flag(mqttIcon, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_set_style_text_color(mqttIcon, lv_color_hex(0x3FC1C9), LV_PART_MAIN | LV_STATE_DEFAULT); // Blue for connected
-  } else {
-    lv_obj_clear_flag(mqttIcon, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_set_style_text_color(mqttIcon, lv_color_hex(0xFF5757), LV_PART_MAIN | LV_STATE_DEFAULT); // Red for disconnected
+  if (mqttState != renderedMqttState) {
+    if (mqttState == 1) {
+      lv_obj_set_style_text_color(mqttIcon, lv_color_hex(0x3FC1C9), LV_PART_MAIN | LV_STATE_DEFAULT); // Blue for connected
+    } else if (mqttState == 2) {
+      lv_obj_set_style_text_color(mqttIcon, lv_color_hex(0xFFAA00), LV_PART_MAIN | LV_STATE_DEFAULT); // Orange while connecting
+    } else {
+      lv_obj_set_style_text_color(mqttIcon, lv_color_hex(0xFF5757), LV_PART_MAIN | LV_STATE_DEFAULT); // Red for disconnected
+    }
+    renderedMqttState = mqttState;
   }
   
   // WiFi connection icon
-  if (WiFi.status() == WL_CONNECTED) {
-    lv_obj_clear_flag(wifiIcon, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_set_style_text_color(wifiIcon, lv_color_hex(0x3FC1C9), LV_PART_MAIN | LV_STATE_DEFAULT); // Blue for connected
-  } else {
-    lv_obj_clear_flag(wifiIcon, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_set_style_text_color(wifiIcon, lv_color_hex(0xFF5757), LV_PART_MAIN | LV_STATE_DEFAULT); // Red for disconnected
+  if (wifiState != renderedWifiState) {
+    if (wifiState) {
+      lv_obj_set_style_text_color(wifiIcon, lv_color_hex(0x3FC1C9), LV_PART_MAIN | LV_STATE_DEFAULT); // Blue for connected
+    } else {
+      lv_obj_set_style_text_color(wifiIcon, lv_color_hex(0xFF5757), LV_PART_MAIN | LV_STATE_DEFAULT); // Red for disconnected
+    }
+    renderedWifiState = wifiState;
   }
+}
+
+// Update the main screen for the current page. Card contents follow
+// the unit subjects, so this only needs to run when the page changes.
+void updateMainScreen() {
+  updateStatusIcons();
   
   // Calculate pagination
   int totalPages = (numUnits + unitsPerPage - 1) / unitsPerPage;
   int startUnit = currentPage * unitsPerPage;
   int endUnit = min(startUnit + unitsPerPage, numUnits);
   
-  // Update page indicator
-  char pageText[20];
-  sprintf(pageText, "Pagina %d/%d", currentPage + 1, totalPages);
-  lv_label_set_text(pageIndicator, pageText);
-  
-  // First, hide all unit cards
-  for (int i = 0; i < unitsPerPage; i++) {
-    lv_obj_add_flag(unitCards[i], LV_OBJ_FLAG_HIDDEN);
-    lv_obj_clean(unitCards[i]); // Clear all children
+  // Update page indicator only when the page changed
+  static int renderedPage = -1;
+  if (renderedPage != currentPage) {
+    char pageText[20];
+    sprintf(pageText, "Pagina %d/%d", currentPage + 1, totalPages);
+    lv_label_set_text(pageIndicator, pageText);
+    renderedPage = currentPage;
   }
   
-  // Update unit cards
+  // Bind each card to the unit it shows on this page
   for (int i = 0; i < unitsPerPage; i++) {
     int unitIndex = startUnit + i;
     
     if (unitIndex < numUnits) {
-      // Show and update card
-      lv_obj_clear_flag(unitCards[i], LV_OBJ_FLAG_HIDDEN);
-      
-      // Store unit index in user data
-      lv_obj_set_user_data(unitCards[i], (void*)(intptr_t)unitIndex);
-      
-      // Reset background color and add visual feedback for touch
-      lv_obj_set_style_bg_color(unitCards[i], lv_color_hex(0x364156), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(unitCards[i], lv_color_hex(0x465166), LV_PART_MAIN | LV_STATE_PRESSED);
-      
-      // Unit name - left side with proper spacing
-      lv_obj_t *nameLabel = lv_label_create(unitCards[i]);
-      lv_label_set_text(nameLabel, acUnits[unitIndex].name);
-      lv_obj_align(nameLabel, LV_ALIGN_LEFT_MID, 8, 0);
-      lv_obj_set_style_text_font(nameLabel, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_text_color(nameLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_width(nameLabel, 130); // Adequate width for unit names
-      lv_label_set_long_mode(nameLabel, LV_LABEL_LONG_DOT); // Truncate with dots if too long
-      
-      // Current temperature - center right
-      char tempStr[10];
-      sprintf(tempStr, "%.1f°C", acUnits[unitIndex].currentTemp);
-      lv_obj_t *tempLabel = lv_label_create(unitCards[i]);
-      lv_label_set_text(tempLabel, tempStr);
-      lv_obj_align(tempLabel, LV_ALIGN_RIGHT_MID, -30, 0);
-      lv_obj_set_style_text_font(tempLabel, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_text_color(tempLabel, lv_color_hex(0x3FC1C9), LV_PART_MAIN | LV_STATE_DEFAULT);
-      
-      // Status info removed as requested
-      
-      // Status indicator - right side with proper spacing
-      lv_obj_t *statusIndicator = lv_obj_create(unitCards[i]);
-      lv_obj_set_size(statusIndicator, 16, 16);
-      lv_obj_align(statusIndicator, LV_ALIGN_RIGHT_MID, -8, 0);
-      lv_obj_set_style_radius(statusIndicator, 8, LV_PART_MAIN | LV_STATE_DEFAULT);
-      
-      // Set border style for all states
-      lv_obj_set_style_border_width(statusIndicator, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
-      
-      if (acUnits[unitIndex].isOn) {
-        // Unit is on - show color based on mode
-        switch(acUnits[unitIndex].mode) {
-          case 0: // Cool
-            lv_obj_set_style_bg_color(statusIndicator, lv_color_hex(0x2B9AF9), LV_PART_MAIN | LV_STATE_DEFAULT); // Blue
-            lv_obj_set_style_border_color(statusIndicator, lv_color_hex(0x2B9AF9), LV_PART_MAIN | LV_STATE_DEFAULT);
-            break;
-          case 1: // Heat
-            lv_obj_set_style_bg_color(statusIndicator, lv_color_hex(0xFF8100), LV_PART_MAIN | LV_STATE_DEFAULT); // Orange
-            lv_obj_set_style_border_color(statusIndicator, lv_color_hex(0xFF8100), LV_PART_MAIN | LV_STATE_DEFAULT);
-            break;
-          case 2: // Fan
-            lv_obj_set_style_bg_color(statusIndicator, lv_color_hex(0x8A8A8A), LV_PART_MAIN | LV_STATE_DEFAULT); // Grey
-            lv_obj_set_style_border_color(statusIndicator, lv_color_hex(0x8A8A8A), LV_PART_MAIN | LV_STATE_DEFAULT);
-            break;
-          case 3: // Auto
-            lv_obj_set_style_bg_color(statusIndicator, lv_color_hex(0x008000), LV_PART_MAIN | LV_STATE_DEFAULT); // Green
-            lv_obj_set_style_border_color(statusIndicator, lv_color_hex(0x008000), LV_PART_MAIN | LV_STATE_DEFAULT);
-            break;
-          case 4: // Dry
-            lv_obj_set_style_bg_color(statusIndicator, lv_color_hex(0xEFBD07), LV_PART_MAIN | LV_STATE_DEFAULT); // Ocher
-            lv_obj_set_style_border_color(statusIndicator, lv_color_hex(0xEFBD07), LV_PART_MAIN | LV_STATE_DEFAULT);
-            break;
-          default:
-            lv_obj_set_style_bg_color(statusIndicator, lv_color_hex(0x2B9AF9), LV_PART_MAIN | LV_STATE_DEFAULT); // Default blue
-            lv_obj_set_style_border_color(statusIndicator, lv_color_hex(0x2B9AF9), LV_PART_MAIN | LV_STATE_DEFAULT);
-        }
-        lv_obj_set_style_bg_opa(statusIndicator, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
-      } else {
-        // Unit is off - show outline only
-        lv_obj_set_style_bg_opa(statusIndicator, LV_OPA_TRANSP, LV_PART_MAIN | LV_STATE_DEFAULT); // Transparent background
-        lv_obj_set_style_border_color(statusIndicator, lv_color_hex(0xAAAAAA), LV_PART_MAIN | LV_STATE_DEFAULT); // Light grey border
-      }
-    } else {
+      bindUnitCard(i, unitIndex);
+    } else if (cardSnapshots[i].unitIndex != -1) {
       // Hide unused cards
+      unbindUnitCard(i);
       lv_obj_add_flag(unitCards[i], LV_OBJ_FLAG_HIDDEN);
+      cardSnapshots[i].unitIndex = -1;
+    }
+    
+    // Reset background color after click feedback
+    if (cardSnapshots[i].highlighted) {
+      lv_obj_set_style_bg_color(unitCards[i], lv_color_hex(0x364156), LV_PART_MAIN | LV_STATE_DEFAULT);
+      cardSnapshots[i].highlighted = false;
     }
   }
   
@@ -332,24 +469,24 @@ void unit_card_event_cb(lv_event_t *e) {
   
   // Provide visual feedback based on event type
   if (code == LV_EVENT_PRESSED) {
-    Serial.print("Card PRESSED for unit: ");
-    Serial.println(unitIndex);
+    LOG_DEBUG("Card PRESSED for unit: %d\n", unitIndex);
     // Visual feedback is handled by styles
     return;
   }
   
   if (code == LV_EVENT_CLICKED) {
-    Serial.print("Card CLICKED for unit: ");
-    Serial.println(unitIndex);
+    LOG_DEBUG("Card CLICKED for unit: %d\n", unitIndex);
     
     // Store the selected unit index
     selectedUnit = unitIndex;
     
     // Show a brief visual feedback before switching screens
     lv_obj_set_style_bg_color(card, lv_color_hex(0x3FC1C9), LV_PART_MAIN | LV_STATE_DEFAULT);
+    for (int i = 0; i < unitsPerPage; i++) {
+      if (unitCards[i] == card) cardSnapshots[i].highlighted = true;
+    }
     
-    Serial.print("Opening detail screen for unit: ");
-    Serial.println(unitIndex);
+    LOG_DEBUG("Opening detail screen for unit: %d\n", unitIndex);
     
     // Force LVGL to process the current state
     lv_timer_handler();
@@ -366,7 +503,7 @@ void unit_card_event_cb(lv_event_t *e) {
     // Force LVGL to process the screen change immediately
     lv_timer_handler();
     
-    Serial.println("Unit control screen should now be visible");
+    LOG_DEBUG("Unit control screen should now be visible\n");
   }
 }
 
@@ -375,7 +512,7 @@ void prev_page_event_cb(lv_event_t *e) {
   lv_obj_t *btn = (lv_obj_t *)lv_event_get_target(e);
   
   if (code == LV_EVENT_CLICKED) {
-    Serial.println("Previous page button clicked");
+    LOG_DEBUG("Previous page button clicked\n");
     
     // Show visual feedback
     lv_obj_set_style_bg_color(btn, lv_color_hex(0x2AA1A9), LV_PART_MAIN | LV_STATE_DEFAULT);
@@ -385,8 +522,7 @@ void prev_page_event_cb(lv_event_t *e) {
     
     if (currentPage > 0) {
       currentPage--;
-      Serial.print("Moving to page: ");
-      Serial.println(currentPage);
+      LOG_DEBUG("Moving to page: %d\n", currentPage);
       
       // Small delay for visual feedback
       delay(50);
@@ -396,9 +532,9 @@ void prev_page_event_cb(lv_event_t *e) {
       
       // Force LVGL to process the screen update immediately
       lv_timer_handler();
-      Serial.println("Screen should now be updated to previous page");
+      LOG_DEBUG("Screen should now be updated to previous page\n");
     } else {
-      Serial.println("Already at first page");
+      LOG_DEBUG("Already at first page\n");
       
       // Small delay for visual feedback
       delay(50);
@@ -417,7 +553,7 @@ void next_page_event_cb(lv_event_t *e) {
   lv_obj_t *btn = (lv_obj_t *)lv_event_get_target(e);
   
   if (code == LV_EVENT_CLICKED) {
-    Serial.println("Next page button clicked");
+    LOG_DEBUG("Next page button clicked\n");
     
     // Show visual feedback
     lv_obj_set_style_bg_color(btn, lv_color_hex(0x2AA1A9), LV_PART_MAIN | LV_STATE_DEFAULT);
@@ -426,13 +562,11 @@ void next_page_event_cb(lv_event_t *e) {
     lv_timer_handler();
     
     int totalPages = (numUnits + unitsPerPage - 1) / unitsPerPage;
-    Serial.print("Total pages: ");
-    Serial.println(totalPages);
+    LOG_DEBUG("Total pages: %d\n", totalPages);
     
     if (currentPage < totalPages - 1) {
       currentPage++;
-      Serial.print("Moving to page: ");
-      Serial.println(currentPage);
+      LOG_DEBUG("Moving to page: %d\n", currentPage);
       
       // Small delay for visual feedback
       delay(50);
@@ -442,9 +576,9 @@ void next_page_event_cb(lv_event_t *e) {
       
       // Force LVGL to process the screen update immediately
       lv_timer_handler();
-      Serial.println("Screen should now be updated to next page");
+      LOG_DEBUG("Screen should now be updated to next page\n");
     } else {
-      Serial.println("Already at last page");
+      LOG_DEBUG("Already at last page\n");
       
       // Small delay for visual feedback
       delay(50);
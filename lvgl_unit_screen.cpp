@@ -1,6 +1,8 @@
 #include <lvgl.h>
 #include "src/ac_controller_lvgl.h"
 
+static void createUnitModals();
+
 // Create the unit control screen
 void createUnitScreen() {
   // Create unit screen with fixed width (non-scrollable)
@@ -228,123 +230,164 @@ void createUnitScreen() {
   lv_label_set_text(powerLabel, "POWER"); // Shortened from "POWER OFF" to fit better
   lv_obj_set_style_text_font(powerLabel, &lv_font_montserrat_12, LV_PART_MAIN | LV_STATE_DEFAULT); // Use available font
   lv_obj_center(powerLabel);
+  
+  // Modals last so they stay above the other widgets
+  createUnitModals();
 }
 
-// Update the unit screen with current data
-void updateUnitScreen(int unitIndex) {
-  if (unitIndex < 0 || unitIndex >= numUnits) return;
-  
-  ACUnit *unit = &acUnits[unitIndex];
-  
-  // Update unit name in header
-  lv_label_set_text(unitTitle, unit->name);
-  
-  // Update current temperature display
-  char tempStr[15];
-  sprintf(tempStr, "%.1f°C", unit->currentTemp);
-  lv_label_set_text(tempDisplay, tempStr);
-  
-  // Update current mode display
-  lv_obj_t *statusSection = lv_obj_get_child(unitScreen, 1); // Get status section
-  lv_obj_t *modeValue = lv_obj_get_child(statusSection, 2); // Get mode value label
-  
-  // Set mode text and color based on current mode
-  if (!unit->isOn) {
-    lv_label_set_text(modeValue, "Off");
-    lv_obj_set_style_text_color(modeValue, lv_color_hex(0xAAAAAA), LV_PART_MAIN | LV_STATE_DEFAULT); // Grey for off
-  } else {
-    lv_label_set_text(modeValue, modeNames[unit->mode]);
-    
-    // Set color based on mode
-    switch(unit->mode) {
-      case 0: // Cool
-        lv_obj_set_style_text_color(modeValue, lv_color_hex(0x2B9AF9), LV_PART_MAIN | LV_STATE_DEFAULT); // Blue
-        break;
-      case 1: // Heat
-        lv_obj_set_style_text_color(modeValue, lv_color_hex(0xFF8100), LV_PART_MAIN | LV_STATE_DEFAULT); // Orange
-        break;
-      case 2: // Fan
-        lv_obj_set_style_text_color(modeValue, lv_color_hex(0x8A8A8A), LV_PART_MAIN | LV_STATE_DEFAULT); // Grey
-        break;
-      case 3: // Auto
-        lv_obj_set_style_text_color(modeValue, lv_color_hex(0x008000), LV_PART_MAIN | LV_STATE_DEFAULT); // Green
-        break;
-      case 4: // Dry
-        lv_obj_set_style_text_color(modeValue, lv_color_hex(0xEFBD07), LV_PART_MAIN | LV_STATE_DEFAULT); // Ocher
-        break;
-      default:
-        lv_obj_set_style_text_color(modeValue, lv_color_hex(0x2B9AF9), LV_PART_MAIN | LV_STATE_DEFAULT); // Default blue
+// Option buttons of the persistent modals, indexed by mode/fan/swing value
+static lv_obj_t *modeOptionButtons[5];
+static lv_obj_t *fanOptionButtons[4];
+static lv_obj_t *swingOptionButtons[5];
+
+// Mark the option button of the current value, only touching buttons
+// whose state actually changes
+static void setModalSelection(lv_obj_t **buttons, int count, int selected) {
+  for (int i = 0; i < count; i++) {
+    bool checked = lv_obj_has_state(buttons[i], LV_STATE_CHECKED);
+    if (i == selected && !checked) {
+      lv_obj_add_state(buttons[i], LV_STATE_CHECKED);
+    } else if (i != selected && checked) {
+      lv_obj_clear_state(buttons[i], LV_STATE_CHECKED);
     }
   }
-  
-  // Update temperature value display
-  float targetTemp = (float)unit->targetTemp; // Use direct Celsius value from MQTT
-  sprintf(tempStr, "%.0f°C", targetTemp);
-  lv_obj_t *tempSection = lv_obj_get_child(unitScreen, 2); // Get temperature section
-  lv_obj_t *tempControlContainer = lv_obj_get_child(tempSection, 1); // Get temperature control container
-  lv_obj_t *tempValue = lv_obj_get_child(tempControlContainer, 1); // Get temperature value label
-  lv_label_set_text(tempValue, tempStr);
-  
-  // Update mode button text and color
+}
+
+// Unit the unit screen widgets observe, -1 when unbound
+static int boundUnit = -1;
+static lv_observer_t *unitObservers[AC_FIELD_COUNT];
+
+// Set mode label and mode button text and color from power state and mode
+static void renderUnitMode(ACUnit *unit) {
+  lv_obj_t *statusSection = lv_obj_get_child(unitScreen, 1); // Get status section
+  lv_obj_t *modeValue = lv_obj_get_child(statusSection, 2); // Get mode value label
   lv_obj_t *modeSection = lv_obj_get_child(unitScreen, 3); // Get mode section
   lv_obj_t *modeButton = lv_obj_get_child(modeSection, 1); // Get mode button
   lv_obj_t *modeButtonLabel = lv_obj_get_child(modeButton, 0); // Get mode button label
   
   if (!unit->isOn) {
+    lv_label_set_text(modeValue, "Off");
+    lv_obj_set_style_text_color(modeValue, lv_color_hex(0xAAAAAA), LV_PART_MAIN | LV_STATE_DEFAULT); // Grey for off
     lv_label_set_text(modeButtonLabel, "OFF");
     lv_obj_set_style_bg_color(modeButton, lv_color_hex(0x666666), LV_PART_MAIN | LV_STATE_DEFAULT); // Grey for off
-  } else {
-    lv_label_set_text(modeButtonLabel, modeNames[unit->mode]);
-    
-    // Set button color based on mode
-    switch(unit->mode) {
-      case 0: // Cool
-        lv_obj_set_style_bg_color(modeButton, lv_color_hex(0x2B9AF9), LV_PART_MAIN | LV_STATE_DEFAULT); // Blue
-        break;
-      case 1: // Heat
-        lv_obj_set_style_bg_color(modeButton, lv_color_hex(0xFF8100), LV_PART_MAIN | LV_STATE_DEFAULT); // Orange
-        break;
-      case 2: // Fan
-        lv_obj_set_style_bg_color(modeButton, lv_color_hex(0x8A8A8A), LV_PART_MAIN | LV_STATE_DEFAULT); // Grey
-        break;
-      case 3: // Auto
-        lv_obj_set_style_bg_color(modeButton, lv_color_hex(0x008000), LV_PART_MAIN | LV_STATE_DEFAULT); // Green
-        break;
-      case 4: // Dry
-        lv_obj_set_style_bg_color(modeButton, lv_color_hex(0xEFBD07), LV_PART_MAIN | LV_STATE_DEFAULT); // Ocher
-        break;
-      default:
-        lv_obj_set_style_bg_color(modeButton, lv_color_hex(0x2B9AF9), LV_PART_MAIN | LV_STATE_DEFAULT); // Default blue
-    }
+    return;
   }
   
-  // Update fan speed button
-  lv_obj_t *fanSection = lv_obj_get_child(unitScreen, 4); // Get fan section
-  lv_obj_t *fanButton = lv_obj_get_child(fanSection, 1); // Get fan button
-  lv_obj_t *fanButtonLabel = lv_obj_get_child(fanButton, 0); // Get fan button label
-  lv_label_set_text(fanButtonLabel, fanNames[unit->fanSpeed]);
-  
-  // Update swing button
-  lv_obj_t *swingSection = lv_obj_get_child(unitScreen, 5); // Get swing section
-  lv_obj_t *swingButton = lv_obj_get_child(swingSection, 1); // Get swing button
-  lv_obj_t *swingButtonLabel = lv_obj_get_child(swingButton, 0); // Get swing button label
-  lv_label_set_text(swingButtonLabel, swingNames[unit->swingMode]);
-  
-  // Update power button text and styling based on current state
+  lv_label_set_text(modeValue, modeNames[unit->mode]);
+  lv_label_set_text(modeButtonLabel, modeNames[unit->mode]);
+  
+  // Set color based on mode
+  lv_color_t modeColor;
+  switch(unit->mode) {
+    case 0: modeColor = lv_color_hex(0x2B9AF9); break; // Cool - Blue
+    case 1: modeColor = lv_color_hex(0xFF8100); break; // Heat - Orange
+    case 2: modeColor = lv_color_hex(0x8A8A8A); break; // Fan - Grey
+    case 3: modeColor = lv_color_hex(0x008000); break; // Auto - Green
+    case 4: modeColor = lv_color_hex(0xEFBD07); break; // Dry - Ocher
+    default: modeColor = lv_color_hex(0x2B9AF9); // Default blue
+  }
+  lv_obj_set_style_text_color(modeValue, modeColor, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_bg_color(modeButton, modeColor, LV_PART_MAIN | LV_STATE_DEFAULT);
+}
+
+// Update power button text and styling based on current state
+static void renderUnitPower(ACUnit *unit) {
   lv_obj_t *powerLabel = lv_obj_get_child(powerButton, 0);
+  lv_label_set_text(powerLabel, "POWER");
   if (unit->isOn) {
-    lv_label_set_text(powerLabel, "POWER");
     lv_obj_set_style_bg_color(powerButton, lv_color_hex(0xFF0000), LV_PART_MAIN | LV_STATE_DEFAULT); // Red for power off
     lv_obj_clear_state(powerButton, LV_STATE_DISABLED); // Enable button
     lv_obj_set_style_bg_opa(powerButton, 255, LV_PART_MAIN | LV_STATE_DEFAULT); // Full opacity
   } else {
-    lv_label_set_text(powerLabel, "POWER");
     lv_obj_set_style_bg_color(powerButton, lv_color_hex(0x666666), LV_PART_MAIN | LV_STATE_DEFAULT); // Grey when off
     lv_obj_add_state(powerButton, LV_STATE_DISABLED); // Disable button when off
     lv_obj_set_style_bg_opa(powerButton, 128, LV_PART_MAIN | LV_STATE_DEFAULT); // Reduced opacity when disabled
   }
 }
 
+// Repaint the widgets that show one field of the bound unit
+static void renderUnitField(ACUnit *unit, int field) {
+  char tempStr[15];
+  
+  switch (field) {
+    case AC_FIELD_CURRENT_TEMP: {
+      // Update current temperature display
+      if (isnan(unit->currentTemp)) strcpy(tempStr, "--.-°C");
+      else sprintf(tempStr, "%.1f°C", unit->currentTemp);
+      lv_label_set_text(tempDisplay, tempStr);
+      break;
+    }
+    case AC_FIELD_POWER:
+      renderUnitMode(unit);
+      renderUnitPower(unit);
+      break;
+    case AC_FIELD_MODE:
+      renderUnitMode(unit);
+      setModalSelection(modeOptionButtons, 5, unit->mode);
+      break;
+    case AC_FIELD_TARGET_TEMP: {
+      // Update temperature value display
+      sprintf(tempStr, "%.0f°C", unit->targetTemp);
+      lv_obj_t *tempSection = lv_obj_get_child(unitScreen, 2); // Get temperature section
+      lv_obj_t *tempControlContainer = lv_obj_get_child(tempSection, 1); // Get temperature control container
+      lv_obj_t *tempValue = lv_obj_get_child(tempControlContainer, 1); // Get temperature value label
+      lv_label_set_text(tempValue, tempStr);
+      break;
+    }
+    case AC_FIELD_FAN: {
+      // Update fan speed button
+      lv_obj_t *fanSection = lv_obj_get_child(unitScreen, 4); // Get fan section
+      lv_obj_t *fanButton = lv_obj_get_child(fanSection, 1); // Get fan button
+      lv_obj_t *fanButtonLabel = lv_obj_get_child(fanButton, 0); // Get fan button label
+      lv_label_set_text(fanButtonLabel, fanNames[unit->fanSpeed]);
+      setModalSelection(fanOptionButtons, 4, unit->fanSpeed);
+      break;
+    }
+    case AC_FIELD_SWING: {
+      // Update swing button
+      lv_obj_t *swingSection = lv_obj_get_child(unitScreen, 5); // Get swing section
+      lv_obj_t *swingButton = lv_obj_get_child(swingSection, 1); // Get swing button
+      lv_obj_t *swingButtonLabel = lv_obj_get_child(swingButton, 0); // Get swing button label
+      lv_label_set_text(swingButtonLabel, swingNames[unit->swingMode]);
+      setModalSelection(swingOptionButtons, 5, unit->swingMode);
+      break;
+    }
+  }
+}
+
+// Called by LVGL when a field of the bound unit changes
+static void unit_field_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+  if (boundUnit < 0) return;
+  int field = (int)(intptr_t)lv_observer_get_user_data(observer);
+  renderUnitField(&acUnits[boundUnit], field);
+}
+
+// Bind the unit screen to a unit. The widgets then follow the unit's
+// subjects, so this only needs to run when a different unit is opened.
+void updateUnitScreen(int unitIndex) {
+  if (unitIndex < 0 || unitIndex >= numUnits) return;
+  if (unitIndex == boundUnit) return;
+  
+  // Stop following the previous unit
+  if (boundUnit >= 0) {
+    for (int f = 0; f < AC_FIELD_COUNT; f++) {
+      lv_observer_remove(unitObservers[f]);
+      unitObservers[f] = NULL;
+    }
+  }
+  boundUnit = unitIndex;
+  
+  ACUnit *unit = &acUnits[unitIndex];
+  
+  // Update unit name in header
+  lv_label_set_text(unitTitle, unit->name);
+  
+  // Adding an observer notifies it once, which renders the field for the new unit
+  for (int f = 0; f < AC_FIELD_COUNT; f++) {
+    unitObservers[f] = lv_subject_add_observer(&unit->subjects[f], unit_field_observer_cb, (void*)(intptr_t)f);
+  }
+}
+
 // Event callbacks for unit screen
 void power_button_event_cb(lv_event_t *e) {
   if (selectedUnit < 0 || selectedUnit >= numUnits) return;
@@ -359,13 +402,11 @@ void power_button_event_cb(lv_event_t *e) {
   // In test mode, directly update the unit's power state without Modbus
   if (testMode) {
     acUnits[selectedUnit].isOn = newState;
+    publishUnitFields(selectedUnit, AC_FIELD_MASK_POWER);
   } else {
     // Normal mode - send to Modbus
     setACPower(selectedUnit, newState);
   }
-  
-  // Update the unit screen to reflect the new power state
-  updateUnitScreen(selectedUnit);
 }
 
 // Temperature minus button callback
@@ -383,13 +424,11 @@ void temp_minus_btn_event_cb(lv_event_t *e) {
     if (testMode) {
       acUnits[selectedUnit].targetTemp = currentValue;
       acUnits[selectedUnit].setTemp = currentValue;
+      publishUnitFields(selectedUnit, AC_FIELD_MASK_TARGET_TEMP);
     } else {
       // Normal mode - send via MQTT
       setACTemperature(selectedUnit, currentValue);
     }
-    
-    // Update temperature display
-    updateUnitScreen(selectedUnit);
   }
 }
 
@@ -408,103 +447,51 @@ void temp_plus_btn_event_cb(lv_event_t *e) {
     if (testMode) {
       acUnits[selectedUnit].targetTemp = currentValue;
       acUnits[selectedUnit].setTemp = currentValue;
+      publishUnitFields(selectedUnit, AC_FIELD_MASK_TARGET_TEMP);
     } else {
       // Normal mode - send via MQTT
       setACTemperature(selectedUnit, currentValue);
     }
-    
-    // Update temperature display
-    updateUnitScreen(selectedUnit);
   }
 }
 
-// Mode selection modal callback
-void mode_select_cb(lv_event_t *e) {
-  lv_obj_t *btn = (lv_obj_t *)lv_event_get_target(e);
-  uint32_t id = (uint32_t)(uintptr_t)lv_obj_get_user_data(btn);
-  
-  Serial.println("=== MODE SELECTION START ===");
-  Serial.print("Selected unit: ");
-  Serial.print(selectedUnit);
-  Serial.print(" (");
-  Serial.print(acUnits[selectedUnit].name);
-  Serial.println(")");
-  Serial.print("Selected mode: ");
-  Serial.print(id);
-  Serial.print(" (");
-  Serial.print(modeNames[id]);
-  Serial.println(")");
-  
-  // Turn on the unit when a mode is selected
-  if (testMode) {
-    acUnits[selectedUnit].isOn = true;
-    acUnits[selectedUnit].mode = id;
-    Serial.println("TEST MODE: Updated local state");
-  } else {
-    // Normal mode - send to MQTT and update local state optimistically
-    if (mqttClient.connected()) {
-      Serial.print("BEFORE MQTT - Unit ");
-      Serial.print(acUnits[selectedUnit].name);
-      Serial.print(": Power=");
-      Serial.print(acUnits[selectedUnit].isOn ? "on" : "off");
-      Serial.print(", Mode=");
-      Serial.println(acUnits[selectedUnit].mode);
-      
-      // Send MQTT commands
-      char powerTopic[100];
-      sprintf(powerTopic, "hcy/airco/%s/command/power", acUnits[selectedUnit].mqttTopic);
-      mqttClient.publish(powerTopic, "on");
-      Serial.print("Published to ");
-      Serial.print(powerTopic);
-      Serial.println(": on");
-      
-      char modeTopic[100];
-      sprintf(modeTopic, "hcy/airco/%s/command/mode", acUnits[selectedUnit].mqttTopic);
-      String modeStr = String(modeNamesEN[id]);
-      modeStr.toLowerCase();
-      if (modeStr == "fan") modeStr = "fan_only";
-      mqttClient.publish(modeTopic, modeStr.c_str());
-      Serial.print("Published to ");
-      Serial.print(modeTopic);
-      Serial.print(": ");
-      Serial.println(modeStr);
-      
-      // Update local state immediately for UI responsiveness
-      acUnits[selectedUnit].isOn = true;
-      acUnits[selectedUnit].mode = id;
-      
-      Serial.print("AFTER LOCAL UPDATE - Unit ");
-      Serial.print(acUnits[selectedUnit].name);
-      Serial.print(": Power=");
-      Serial.print(acUnits[selectedUnit].isOn ? "on" : "off");
-      Serial.print(", Mode=");
-      Serial.println(acUnits[selectedUnit].mode);
-    }
-  }
-  
-  // Close the modal
-  lv_obj_t *modal = lv_obj_get_parent(lv_obj_get_parent(btn));
-  lv_obj_del(modal);
-  
-  // Update status display
-  updateUnitScreen(selectedUnit);
-  Serial.println("=== MODE SELECTION END ===");
+// Hide a modal without making any changes
+static void hideModal(lv_obj_t *modal) {
+  if (modal) lv_obj_add_flag(modal, LV_OBJ_FLAG_HIDDEN);
 }
 
-// Mode button event callback - opens modal with mode options
-void mode_button_modal_event_cb(lv_event_t *e) {
-  if (selectedUnit < 0 || selectedUnit >= numUnits) return;
-  
+void hideUnitModals() {
+  hideModal(modeModal);
+  hideModal(fanModal);
+  hideModal(swingModal);
+}
+
+static void modal_close_cb(lv_event_t *e) {
+  hideModal((lv_obj_t *)lv_event_get_user_data(e));
+}
+
+// Show a modal; it is the topmost child of the unit screen, so this
+// only invalidates the overlay
+static void showModal(lv_obj_t *modal) {
+  lv_obj_clear_flag(modal, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Build a hidden modal: full screen overlay, container, header and close button.
+// Returns the container the option buttons go in.
+static lv_obj_t *createModal(lv_obj_t **modal, const char *title, int32_t width, int32_t height) {
   // Create a modal background
-  lv_obj_t *modal = lv_obj_create(lv_scr_act());
-  lv_obj_set_size(modal, LV_PCT(100), LV_PCT(100));
-  lv_obj_set_style_bg_color(modal, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_bg_opa(modal, 180, LV_PART_MAIN | LV_STATE_DEFAULT); // Semi-transparent
-  lv_obj_set_style_border_width(modal, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-  
-  // Create a container for the mode buttons
-  lv_obj_t *cont = lv_obj_create(modal);
-  lv_obj_set_size(cont, 200, 220); // Increased height from 190 to 220 to fit header and all buttons
+  *modal = lv_obj_create(unitScreen);
+  lv_obj_set_size(*modal, LV_PCT(100), LV_PCT(100));
+  lv_obj_set_style_bg_color(*modal, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_bg_opa(*modal, 180, LV_PART_MAIN | LV_STATE_DEFAULT); // Semi-transparent
+  lv_obj_set_style_border_width(*modal, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_radius(*modal, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_clear_flag(*modal, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(*modal, LV_OBJ_FLAG_HIDDEN);
+  
+  // Create a container for the option buttons
+  lv_obj_t *cont = lv_obj_create(*modal);
+  lv_obj_set_size(cont, width, height);
   lv_obj_center(cont);
   lv_obj_set_style_bg_color(cont, lv_color_hex(0x364156), LV_PART_MAIN | LV_STATE_DEFAULT);
   lv_obj_set_style_radius(cont, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
@@ -513,7 +500,7 @@ void mode_button_modal_event_cb(lv_event_t *e) {
   
   // Add header text
   lv_obj_t *headerLabel = lv_label_create(cont);
-  lv_label_set_text(headerLabel, "Kies Modus");
+  lv_label_set_text(headerLabel, title);
   lv_obj_align(headerLabel, LV_ALIGN_TOP_MID, 0, 5);
   lv_obj_set_style_text_font(headerLabel, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
   lv_obj_set_style_text_color(headerLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
@@ -524,44 +511,55 @@ void mode_button_modal_event_cb(lv_event_t *e) {
   lv_obj_align(closeBtn, LV_ALIGN_TOP_RIGHT, 0, 0);
   lv_obj_set_style_radius(closeBtn, 12, LV_PART_MAIN | LV_STATE_DEFAULT); // Make it circular
   lv_obj_set_style_bg_color(closeBtn, lv_color_hex(0x666666), LV_PART_MAIN | LV_STATE_DEFAULT); // Grey
-  lv_obj_add_event_cb(closeBtn, [](lv_event_t *e) {
-    // Close the modal without making any changes
-    lv_obj_t *btn = (lv_obj_t *)lv_event_get_target(e);
-    lv_obj_t *modal = lv_obj_get_parent(lv_obj_get_parent(btn));
-    lv_obj_del(modal);
-  }, LV_EVENT_CLICKED, NULL);
+  lv_obj_add_event_cb(closeBtn, modal_close_cb, LV_EVENT_CLICKED, *modal);
   
   lv_obj_t *closeLabel = lv_label_create(closeBtn);
   lv_label_set_text(closeLabel, "X"); // Simple X character instead of Unicode
   lv_obj_center(closeLabel);
   lv_obj_set_style_text_font(closeLabel, &lv_font_montserrat_12, LV_PART_MAIN | LV_STATE_DEFAULT);
   
-  // Create mode buttons (removed OFF mode)
-  const char* modes[] = {"Koelen", "Verwarmen", "Ventilatie", "Auto", "Drogen"};
-  lv_color_t colors[] = {
-    lv_color_hex(0x2B9AF9), // Blue for Cool
-    lv_color_hex(0xFF8100), // Orange for Heat
-    lv_color_hex(0x8A8A8A), // Grey for Fan
-    lv_color_hex(0x008000), // Green for Auto
-    lv_color_hex(0xEFBD07)  // Ocher for Dry
-  };
+  return cont;
+}
+
+// Add an option button; the value is stored as user data and the
+// selected option gets a white border
+static lv_obj_t *createModalOption(lv_obj_t *cont, const char *text, int value, lv_color_t color,
+                                   int32_t width, int32_t y, lv_event_cb_t cb) {
+  lv_obj_t *btn = lv_btn_create(cont);
+  lv_obj_set_size(btn, width, 30);
+  lv_obj_align(btn, LV_ALIGN_TOP_MID, 0, y);
+  lv_obj_set_style_bg_color(btn, color, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_set_style_bg_color(btn, color, LV_PART_MAIN | LV_STATE_CHECKED); // Keep the option color when selected
+  lv_obj_set_style_border_color(btn, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_CHECKED);
+  lv_obj_set_style_border_width(btn, 2, LV_PART_MAIN | LV_STATE_CHECKED);
+  
+  lv_obj_t *label = lv_label_create(btn);
+  lv_label_set_text(label, text);
+  lv_obj_center(label);
+  
+  lv_obj_set_user_data(btn, (void*)(uintptr_t)value);
+  lv_obj_add_event_cb(btn, cb, LV_EVENT_CLICKED, NULL);
+  return btn;
+}
+
+// Mode selection modal callback
+void mode_select_cb(lv_event_t *e) {
+  lv_obj_t *btn = (lv_obj_t *)lv_event_get_target(e);
+  uint32_t id = (uint32_t)(uintptr_t)lv_obj_get_user_data(btn);
   
-  for (int i = 0; i < 5; i++) { // Changed from 6 to 5 (removed OFF)
-    lv_obj_t *btn = lv_btn_create(cont);
-    lv_obj_set_size(btn, 160, 30);
-    lv_obj_align(btn, LV_ALIGN_TOP_MID, 0, 55 + i * 32); // Moved down from 30 to 55 to accommodate header
-    lv_obj_set_style_bg_color(btn, colors[i], LV_PART_MAIN | LV_STATE_DEFAULT);
-    
-    lv_obj_t *label = lv_label_create(btn);
-    lv_label_set_text(label, modes[i]);
-    lv_obj_center(label);
-    
-    // Store the mode ID as user data
-    lv_obj_set_user_data(btn, (void*)(uintptr_t)i); // For modes 0-4
-    
-    // Add click event - all buttons use mode_select_cb now
-    lv_obj_add_event_cb(btn, mode_select_cb, LV_EVENT_CLICKED, NULL);
-  }
+  // Turn on the unit when a mode is selected. Both go through the command
+  // queue, which keeps a late status from reverting them until confirmed.
+  setACPower(selectedUnit, true);
+  setACMode(selectedUnit, id);
+  
+  // Close the modal
+  hideModal(modeModal);
+}
+
+// Mode button event callback - opens the mode modal
+void mode_button_modal_event_cb(lv_event_t *e) {
+  if (selectedUnit < 0 || selectedUnit >= numUnits) return;
+  showModal(modeModal);
 }
 
 // Fan speed selection modal callback
@@ -572,169 +570,81 @@ void fan_select_cb(lv_event_t *e) {
   // In test mode, directly update the unit's fan speed
   if (testMode) {
     acUnits[selectedUnit].fanSpeed = id;
+    publishUnitFields(selectedUnit, AC_FIELD_MASK_FAN);
   } else {
     // Normal mode - send to Modbus
     setACFanSpeed(selectedUnit, id);
   }
   
   // Close the modal
-  lv_obj_t *modal = lv_obj_get_parent(lv_obj_get_parent(btn));
-  lv_obj_del(modal);
-  
-  // Update status display
-  updateUnitScreen(selectedUnit);
+  hideModal(fanModal);
 }
 
-// Fan button event callback - opens modal with fan speed options
+// Fan button event callback - opens the fan speed modal
 void fan_button_event_cb(lv_event_t *e) {
   if (selectedUnit < 0 || selectedUnit >= numUnits) return;
   if (!acUnits[selectedUnit].isOn) return; // Don't open fan modal if unit is off
-  
-  // Create a modal background
-  lv_obj_t *modal = lv_obj_create(lv_scr_act());
-  lv_obj_set_size(modal, LV_PCT(100), LV_PCT(100));
-  lv_obj_set_style_bg_color(modal, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_bg_opa(modal, 180, LV_PART_MAIN | LV_STATE_DEFAULT); // Semi-transparent
-  lv_obj_set_style_border_width(modal, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-  
-  // Create a container for the fan speed buttons
-  lv_obj_t *cont = lv_obj_create(modal);
-  lv_obj_set_size(cont, 180, 220); // Increased height to fit header and 4 fan speed buttons
-  lv_obj_center(cont);
-  lv_obj_set_style_bg_color(cont, lv_color_hex(0x364156), LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_radius(cont, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_pad_all(cont, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_clear_flag(cont, LV_OBJ_FLAG_SCROLLABLE); // Make it unscrollable
-  
-  // Add header text
-  lv_obj_t *headerLabel = lv_label_create(cont);
-  lv_label_set_text(headerLabel, "Kies Fan Snelheid");
-  lv_obj_align(headerLabel, LV_ALIGN_TOP_MID, 0, 5);
-  lv_obj_set_style_text_font(headerLabel, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_text_color(headerLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-  
-  // Close button (X) in the top right
-  lv_obj_t *closeBtn = lv_btn_create(cont);
-  lv_obj_set_size(closeBtn, 24, 24);
-  lv_obj_align(closeBtn, LV_ALIGN_TOP_RIGHT, 0, 0);
-  lv_obj_set_style_radius(closeBtn, 12, LV_PART_MAIN | LV_STATE_DEFAULT); // Make it circular
-  lv_obj_set_style_bg_color(closeBtn, lv_color_hex(0x666666), LV_PART_MAIN | LV_STATE_DEFAULT); // Grey
-  lv_obj_add_event_cb(closeBtn, [](lv_event_t *e) {
-    // Close the modal without making any changes
-    lv_obj_t *btn = (lv_obj_t *)lv_event_get_target(e);
-    lv_obj_t *modal = lv_obj_get_parent(lv_obj_get_parent(btn));
-    lv_obj_del(modal);
-  }, LV_EVENT_CLICKED, NULL);
-  
-  lv_obj_t *closeLabel = lv_label_create(closeBtn);
-  lv_label_set_text(closeLabel, "X"); // Simple X character instead of Unicode
-  lv_obj_center(closeLabel);
-  lv_obj_set_style_text_font(closeLabel, &lv_font_montserrat_12, LV_PART_MAIN | LV_STATE_DEFAULT);
-  
-  // Create fan speed buttons - now includes 4 speeds
-  const char* speeds[] = {"Laag", "Gemiddeld", "Hoog", "Krachtig"};
-  
-  for (int i = 0; i < 4; i++) {
-    lv_obj_t *btn = lv_btn_create(cont);
-    lv_obj_set_size(btn, 140, 30);
-    lv_obj_align(btn, LV_ALIGN_TOP_MID, 0, 55 + i * 35); // Moved down from 30 to 55 to accommodate header
-    lv_obj_set_style_bg_color(btn, lv_color_hex(0x666666), LV_PART_MAIN | LV_STATE_DEFAULT);
-    
-    lv_obj_t *label = lv_label_create(btn);
-    lv_label_set_text(label, speeds[i]);
-    lv_obj_center(label);
-    
-    // Store the fan speed ID as user data
-    lv_obj_set_user_data(btn, (void*)(uintptr_t)i);
-    
-    // Add click event
-    lv_obj_add_event_cb(btn, fan_select_cb, LV_EVENT_CLICKED, NULL);
+  showModal(fanModal);
+}
+
+// Swing selection modal callback
+static void swing_select_cb(lv_event_t *e) {
+  lv_obj_t *btn = (lv_obj_t *)lv_event_get_target(e);
+  uint32_t id = (uint32_t)(uintptr_t)lv_obj_get_user_data(btn);
+
+  // In test mode, directly update the unit's swing mode
+  if (testMode) {
+    acUnits[selectedUnit].swingMode = id;
+    publishUnitFields(selectedUnit, AC_FIELD_MASK_SWING);
+  } else {
+    // Normal mode - send via MQTT
+    setACSwing(selectedUnit, id);
   }
+
+  // Close the modal
+  hideModal(swingModal);
 }
 
+// Swing button event callback - opens the swing modal
 void swing_button_event_cb(lv_event_t *e) {
   if (selectedUnit < 0 || selectedUnit >= numUnits) return;
+  showModal(swingModal);
+}
+
+// Build the mode, fan and swing modals once, hidden, on top of the unit screen.
+// The option highlighting follows the bound unit, see renderUnitField().
+static void createUnitModals() {
+  // Mode buttons (no OFF mode)
+  const char* modes[] = {"Koelen", "Verwarmen", "Ventilatie", "Auto", "Drogen"};
+  lv_color_t colors[] = {
+    lv_color_hex(0x2B9AF9), // Blue for Cool
+    lv_color_hex(0xFF8100), // Orange for Heat
+    lv_color_hex(0x8A8A8A), // Grey for Fan
+    lv_color_hex(0x008000), // Green for Auto
+    lv_color_hex(0xEFBD07)  // Ocher for Dry
+  };
+  lv_obj_t *cont = createModal(&modeModal, "Kies Modus", 200, 220);
+  for (int i = 0; i < 5; i++) {
+    modeOptionButtons[i] = createModalOption(cont, modes[i], i, colors[i], 160, 55 + i * 32, mode_select_cb);
+  }
   
-  // Create a modal background
-  lv_obj_t *modal = lv_obj_create(lv_scr_act());
-  lv_obj_set_size(modal, LV_PCT(100), LV_PCT(100));
-  lv_obj_set_style_bg_color(modal, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_bg_opa(modal, 180, LV_PART_MAIN | LV_STATE_DEFAULT); // Semi-transparent
-  lv_obj_set_style_border_width(modal, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-  
-  // Create a container for the swing buttons
-  lv_obj_t *cont = lv_obj_create(modal);
-  lv_obj_set_size(cont, 200, 250); // Increased size to fit all 5 options
-  lv_obj_center(cont);
-  lv_obj_set_style_bg_color(cont, lv_color_hex(0x364156), LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_radius(cont, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_pad_all(cont, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_clear_flag(cont, LV_OBJ_FLAG_SCROLLABLE); // Make it unscrollable
-  
-  // Add header text
-  lv_obj_t *headerLabel = lv_label_create(cont);
-  lv_label_set_text(headerLabel, "Kies Lamelle Modus");
-  lv_obj_align(headerLabel, LV_ALIGN_TOP_MID, 0, 5);
-  lv_obj_set_style_text_font(headerLabel, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_text_color(headerLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-  
-  // Close button (X) in the top right
-  lv_obj_t *closeBtn = lv_btn_create(cont);
-  lv_obj_set_size(closeBtn, 24, 24);
-  lv_obj_align(closeBtn, LV_ALIGN_TOP_RIGHT, 0, 0);
-  lv_obj_set_style_radius(closeBtn, 12, LV_PART_MAIN | LV_STATE_DEFAULT); // Make it circular
-  lv_obj_set_style_bg_color(closeBtn, lv_color_hex(0x666666), LV_PART_MAIN | LV_STATE_DEFAULT); // Grey
-  lv_obj_add_event_cb(closeBtn, [](lv_event_t *e) {
-    // Close the modal without making any changes
-    lv_obj_t *btn = (lv_obj_t *)lv_event_get_target(e);
-    lv_obj_t *modal = lv_obj_get_parent(lv_obj_get_parent(btn));
-    lv_obj_del(modal);
-  }, LV_EVENT_CLICKED, NULL);
-  
-  lv_obj_t *closeLabel = lv_label_create(closeBtn);
-  lv_label_set_text(closeLabel, "X"); // Simple X character instead of Unicode
-  lv_obj_center(closeLabel);
-  lv_obj_set_style_text_font(closeLabel, &lv_font_montserrat_12, LV_PART_MAIN | LV_STATE_DEFAULT);
+  // Fan speed buttons, 4 speeds
+  const char* speeds[] = {"Laag", "Gemiddeld", "Hoog", "Krachtig"};
+  cont = createModal(&fanModal, "Kies Fan Snelheid", 180, 220);
+  for (int i = 0; i < 4; i++) {
+    fanOptionButtons[i] = createModalOption(cont, speeds[i], i, lv_color_hex(0x666666), 140, 55 + i * 35, fan_select_cb);
+  }
   
-  // Create swing buttons for all 5 options
+  // Swing buttons for all 5 options
+  cont = createModal(&swingModal, "Kies Lamelle Modus", 200, 250);
   for (int i = 0; i < 5; i++) {
-    lv_obj_t *btn = lv_btn_create(cont);
-    lv_obj_set_size(btn, 160, 30);
-    lv_obj_align(btn, LV_ALIGN_TOP_MID, 0, 40 + i * 35); // Start at 40 to accommodate header
-    lv_obj_set_style_bg_color(btn, lv_color_hex(0x666666), LV_PART_MAIN | LV_STATE_DEFAULT);
-
-    lv_obj_t *label = lv_label_create(btn);
-    lv_label_set_text(label, swingNames[i]);
-    lv_obj_center(label);
-
-    // Store the swing ID as user data
-    lv_obj_set_user_data(btn, (void*)(uintptr_t)i);
-
-    // Add click event
-    lv_obj_add_event_cb(btn, [](lv_event_t *e) {
-      lv_obj_t *btn = (lv_obj_t *)lv_event_get_target(e);
-      uint32_t id = (uint32_t)(uintptr_t)lv_obj_get_user_data(btn);
-
-      // In test mode, directly update the unit's swing mode
-      if (testMode) {
-        acUnits[selectedUnit].swingMode = id;
-      } else {
-        // Normal mode - send via MQTT
-        setACSwing(selectedUnit, id);
-      }
-
-      // Close the modal
-      lv_obj_t *modal = lv_obj_get_parent(lv_obj_get_parent(btn));
-      lv_obj_del(modal);
-
-      // Update status display
-      updateUnitScreen(selectedUnit);
-    }, LV_EVENT_CLICKED, NULL);
+    swingOptionButtons[i] = createModalOption(cont, swingNames[i], i, lv_color_hex(0x666666), 160, 40 + i * 35, swing_select_cb);
   }
 }
 
 void back_button_event_cb(lv_event_t *e) {
-  // Return to main screen
+  // Return to main screen, an open modal must not be there on the way back
+  hideUnitModals();
   lv_scr_load(mainScreen);
   updateMainScreen();
 }
@@ -2,6 +2,7 @@
 #define AC_CONTROLLER_LVGL_H
 
 #include <lvgl.h>
+#include <atomic>
 
 
 // Always include TFT_eSPI since we're using it in our project
@@ -10,7 +11,9 @@
 #include <WiFi.h>
 #include <PubSubClient.h>
 #include <XPT2046_Touchscreen.h>
-#include <ArduinoJson.h>
+#include "latency_histogram.h"
+#include "touch_calibration.h"
+#include "serial_log.h"
 
 // External declarations for global objects
 extern TFT_eSPI tft;
@@ -24,6 +27,16 @@ extern const char* mqttPassword;
 // Test mode flag to skip MQTT connection
 extern bool testMode;
 
+// MQTT link state, advanced one step at a time by mqttLinkStep() in the network task
+enum MqttLinkState {
+  MQTT_LINK_IDLE,        // Connected, or nothing to do (no WiFi, test mode)
+  MQTT_LINK_CONNECTING,  // Next step calls connect()
+  MQTT_LINK_SUBSCRIBING, // Sending the status subscriptions
+  MQTT_LINK_BACKOFF      // Waiting for the next connect attempt
+};
+extern std::atomic<MqttLinkState> mqttLinkState;
+extern std::atomic<bool> mqttConnected; // Kept by the network task, the UI task must not ask mqttClient
+
 // Screen control variables
 extern int currentPage;
 extern int unitsPerPage;
@@ -40,7 +53,49 @@ struct ACUnit {
   uint8_t swingMode;       // Changed from bool swingOn to uint8_t swingMode (0-4)
   float targetTemp;        // Changed to float for MQTT
   float setTemp;           // Changed to float for MQTT - Temperature set by user
+  lv_subject_t subjects[6]; // One LVGL subject per field above, see AC_FIELD_*
+};
+
+// currentTemp until the first status message, shown as "--.-"
+#define AC_TEMP_UNKNOWN NAN
+
+// ACUnit field indices into ACUnit::subjects
+#define AC_FIELD_CURRENT_TEMP 0
+#define AC_FIELD_POWER        1
+#define AC_FIELD_MODE         2
+#define AC_FIELD_FAN          3
+#define AC_FIELD_SWING        4
+#define AC_FIELD_TARGET_TEMP  5
+#define AC_FIELD_COUNT        6
+
+// Field masks for ACUnit fields, passed to publishUnitFields
+#define AC_FIELD_MASK_CURRENT_TEMP (1 << AC_FIELD_CURRENT_TEMP)
+#define AC_FIELD_MASK_POWER        (1 << AC_FIELD_POWER)
+#define AC_FIELD_MASK_MODE         (1 << AC_FIELD_MODE)
+#define AC_FIELD_MASK_FAN          (1 << AC_FIELD_FAN)
+#define AC_FIELD_MASK_SWING        (1 << AC_FIELD_SWING)
+#define AC_FIELD_MASK_TARGET_TEMP  (1 << AC_FIELD_TARGET_TEMP)
+#define AC_FIELD_MASK_ALL          0x3F
+
+// Commands sent to a unit, each has one slot per unit in the outbound queue
+#define AC_COMMAND_POWER       0
+#define AC_COMMAND_MODE        1
+#define AC_COMMAND_FAN         2
+#define AC_COMMAND_SWING       3
+#define AC_COMMAND_TEMPERATURE 4
+#define AC_COMMAND_COUNT       5
+
+// Command round trip statistics, updated when a status message confirms a command
+struct CommandStats {
+  uint32_t confirmed;   // Commands confirmed by a status message
+  uint32_t timedOut;    // Commands not confirmed within COMMAND_CONFIRM_TIMEOUT
+  uint32_t superseded;  // In-flight commands replaced by a newer value before confirmation
+  uint32_t heldBack;    // Status fields ignored because a command for them was pending
+  uint32_t lastRttMs;   // Command to confirming status, last sample
+  uint32_t avgRttMs;    // Moving average, each sample weighs 1/8
 };
+extern CommandStats commandStats;
+extern LatencyHistogram unitLatency[]; // Command to confirmation, one per unit
 
 // External declarations for global arrays (defined in ac_units_config.h)
 extern ACUnit acUnits[];
@@ -58,6 +113,8 @@ extern lv_obj_t *unitDetailScreen;
 extern lv_obj_t *loadingScreen;
 extern lv_obj_t *unitScreen;
 extern lv_obj_t *loadingScreen;
+extern lv_obj_t *diagnosticsScreen;
+extern lv_obj_t *calibrationScreen;
 
 // LVGL objects for main screen
 extern lv_obj_t *mainTitle;
@@ -69,6 +126,7 @@ extern lv_obj_t *unitCards[4]; // One card per unit on screen
 extern lv_obj_t *prevButton;
 extern lv_obj_t *nextButton;
 extern lv_obj_t *pageIndicator;
+extern uint32_t cardRedrawsAvoided; // Card widget refreshes skipped because the value had not changed
 
 // LVGL objects for unit screen
 extern lv_obj_t *unitTitle;
@@ -93,17 +151,43 @@ void createMasterControl();
 void createUnitDetailScreen();
 void updateMainScreen();
 void updateUnitScreen(int unitIndex);
+void hideUnitModals();
+void updateStatusIcons();
+void showUnitCommandProgress(int unitIndex);
 void showUnitDetail(int unitIndex);
+void showDiagnosticsScreen();
+void showCalibrationScreen();
+
+// Touch calibration, applied in the LVGL read callback
+extern TouchCalibration touchCalibration;
+extern TouchCalPoint touchLastRaw; // Last filtered point before calibration, for the calibration screen
+bool saveTouchCalibration(const TouchCalibration *cal);
+
+// Function declarations for MQTT
+void mqttLinkStep(uint32_t now);
+void mqttCallback(char* topic, byte* payload, unsigned int length);
+struct ACStatus; // src/mqtt_status_parser.h
+void applyUnitStatus(int unitIndex, const ACStatus &status, uint32_t now);
+void initStatusTopics();
+int findUnitByStatusTopic(const char* topic);
 
 // Function declarations for data handling
 void updateUnitData(int unitIndex);
 void updateAllUnits();
+void initUnitSubjects();
+void publishUnitFields(int unitIndex, uint8_t fields);
 void setACPower(int unitIndex, bool state);
 void setACMode(int unitIndex, uint8_t mode);
 void setACFanSpeed(int unitIndex, uint8_t speed);
 void setACSwing(int unitIndex, uint8_t state);
 void setACTemperature(int unitIndex, float temp);
 void setAllACPower(bool state);
+void queueUnitCommand(int unitIndex, uint8_t command, int16_t value, uint32_t delayMs);
+void commandQueueStep(uint32_t now);
+uint32_t commandQueueIdleTime(uint32_t now);
+bool unitHasQueuedCommands(int unitIndex);
+bool acceptStatusField(int unitIndex, uint8_t command, int16_t value, uint32_t now);
+void printLatencyHistograms();
 void turnOffAllACUnits();
 
 // Event callbacks for main screen
@@ -0,0 +1,19 @@
+#ifndef FLETCHER16_H
+#define FLETCHER16_H
+
+// Fletcher-16 checksum, shared by the records kept in NVS
+// (src/unit_state_cache.h, src/touch_calibration.h)
+
+#include <stdint.h>
+#include <stddef.h>
+
+inline uint16_t fletcher16(const uint8_t *data, size_t length) {
+  uint16_t sum1 = 0, sum2 = 0;
+  for (size_t i = 0; i < length; i++) {
+    sum1 = (sum1 + data[i]) % 255;
+    sum2 = (sum2 + sum1) % 255;
+  }
+  return (sum2 << 8) | sum1;
+}
+
+#endif // FLETCHER16_H
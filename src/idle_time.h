@@ -0,0 +1,31 @@
+#ifndef IDLE_TIME_H
+#define IDLE_TIME_H
+
+// Idle share of a task. The task adds the time it spends blocked in its
+// wait; once per IDLE_TIME_WINDOW the share of that window is published
+// in `percent`, which other tasks may read.
+
+#include <stdint.h>
+#include <atomic>
+
+#define IDLE_TIME_WINDOW 1000000 // Window in microseconds
+
+struct IdleTime {
+  uint32_t windowStart;          // micros() at the start of the window
+  uint32_t idleMicros;           // Blocked so far in this window
+  std::atomic<uint8_t> percent;  // Idle share of the last full window
+};
+
+// Count one wait from `start` to `end` (micros()) and close the window
+// when it is full
+inline void idleTimeAdd(IdleTime *idle, uint32_t start, uint32_t end) {
+  idle->idleMicros += end - start;
+  uint32_t window = end - idle->windowStart;
+  if (window < IDLE_TIME_WINDOW) return;
+  uint32_t idlePercent = (uint32_t)((uint64_t)idle->idleMicros * 100 / window);
+  idle->percent.store(idlePercent > 100 ? 100 : idlePercent, std::memory_order_relaxed);
+  idle->windowStart = end;
+  idle->idleMicros = 0;
+}
+
+#endif // IDLE_TIME_H
@@ -0,0 +1,71 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+// Fixed-bucket latency histogram with log2 bucket limits. Bucket 0 holds
+// samples below LATENCY_FIRST_BUCKET_MS, every next bucket doubles the
+// limit and the last bucket holds everything above. Recording is a few
+// shifts and an increment, percentiles are read back as bucket limits.
+
+#include <stdint.h>
+
+#define LATENCY_BUCKETS 10
+#define LATENCY_FIRST_BUCKET_MS 64 // Buckets: <64, <128, ... <16384, >=16384 ms
+
+struct LatencyHistogram {
+  uint16_t counts[LATENCY_BUCKETS];
+  uint32_t samples;
+  uint32_t sumMs;
+  uint32_t maxMs;
+};
+
+inline uint8_t latencyBucket(uint32_t ms) {
+  uint8_t bucket = 0;
+  uint32_t limit = LATENCY_FIRST_BUCKET_MS;
+  while (bucket < LATENCY_BUCKETS - 1 && ms >= limit) {
+    bucket++;
+    limit <<= 1;
+  }
+  return bucket;
+}
+
+// Upper limit of a bucket in ms, exclusive; UINT32_MAX for the last one
+inline uint32_t latencyBucketLimit(uint8_t bucket) {
+  if (bucket >= LATENCY_BUCKETS - 1) return UINT32_MAX;
+  return (uint32_t)LATENCY_FIRST_BUCKET_MS << bucket;
+}
+
+inline void latencyRecord(LatencyHistogram *h, uint32_t ms) {
+  uint8_t bucket = latencyBucket(ms);
+  if (h->counts[bucket] < UINT16_MAX) h->counts[bucket]++;
+  h->samples++;
+  h->sumMs += ms;
+  if (ms > h->maxMs) h->maxMs = ms;
+}
+
+// Bucket that holds the given percentile (0-100), -1 without samples
+inline int latencyPercentileBucket(const LatencyHistogram *h, uint8_t percent) {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) total += h->counts[i];
+  if (total == 0) return -1;
+  uint32_t wanted = (total * percent + 99) / 100;
+  if (wanted == 0) wanted = 1;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += h->counts[i];
+    if (seen >= wanted) return i;
+  }
+  return LATENCY_BUCKETS - 1;
+}
+
+// Add the counts of one histogram to another, for the all units view
+inline void latencyMerge(LatencyHistogram *into, const LatencyHistogram *from) {
+  for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+    uint32_t sum = into->counts[i] + from->counts[i];
+    into->counts[i] = sum > UINT16_MAX ? UINT16_MAX : sum;
+  }
+  into->samples += from->samples;
+  into->sumMs += from->sumMs;
+  if (from->maxMs > into->maxMs) into->maxMs = from->maxMs;
+}
+
+#endif // LATENCY_HISTOGRAM_H
@@ -90,6 +90,10 @@
  * - LV_OS_WINDOWS
  * - LV_OS_MQX
  * - LV_OS_CUSTOM */
+/* LVGL is only called from the UI task (loop()), so it needs no OS layer.
+ * LV_OS_FREERTOS would use the loop task's notification slot, which loop()
+ * waits on itself, and start a separate draw thread; see the Taken section
+ * in README.md. */
 #define LV_USE_OS   LV_OS_NONE
 
 #if LV_USE_OS == LV_OS_CUSTOM
@@ -0,0 +1,225 @@
+#ifndef MQTT_STATUS_PARSER_H
+#define MQTT_STATUS_PARSER_H
+
+// Streaming parser for the AC status payload:
+//   {"current_temperature":23.5,"power":"on","hvac_mode":"cool",
+//    "fan_mode":"low","swing_mode":"swing","setpoint":21}
+// Reads straight from the MQTT payload buffer in one pass, without copying
+// it, without allocating and without recursion. Unknown keys are skipped,
+// including nested objects and arrays. Fields that are missing, null or of
+// the wrong type are left out of the result.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "../config/mqtt_config.h"
+
+// Fields present in a parsed status, one bit each
+#define STATUS_HAS_CURRENT_TEMP (1 << 0)
+#define STATUS_HAS_POWER        (1 << 1)
+#define STATUS_HAS_MODE         (1 << 2)
+#define STATUS_HAS_FAN          (1 << 3)
+#define STATUS_HAS_SWING        (1 << 4)
+#define STATUS_HAS_SETPOINT     (1 << 5)
+
+// Longest number we convert, longer ones are treated as invalid
+#define STATUS_NUMBER_MAX_LENGTH 24
+
+struct ACStatus {
+  uint8_t present;    // STATUS_HAS_* bits
+  float currentTemp;
+  bool isOn;
+  uint8_t mode;
+  uint8_t fanSpeed;
+  uint8_t swingMode;
+  float setpoint;
+};
+
+// Cursor over the payload, never reads past end
+struct StatusCursor {
+  const uint8_t *p;
+  const uint8_t *end;
+};
+
+inline bool statusIsSpace(uint8_t ch) {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+inline bool statusIsNumberChar(uint8_t ch) {
+  return (ch >= '0' && ch <= '9') || ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E';
+}
+
+inline bool statusIsDelimiter(uint8_t ch) {
+  return ch == ',' || ch == ':' || ch == ']' || ch == '}' || statusIsSpace(ch);
+}
+
+inline void statusSkipSpace(StatusCursor *c) {
+  while (c->p < c->end && statusIsSpace(*c->p)) c->p++;
+}
+
+// Read a string at the cursor; str/len point into the payload, escapes are
+// skipped but not decoded (none of the known values contain any)
+inline bool statusReadString(StatusCursor *c, const char **str, size_t *len) {
+  if (c->p >= c->end || *c->p != '"') return false;
+  const uint8_t *start = ++c->p;
+  while (c->p < c->end && *c->p != '"') {
+    if (*c->p == '\\' && c->p + 1 < c->end) c->p++;
+    c->p++;
+  }
+  if (c->p >= c->end) return false;
+  *str = (const char *)start;
+  *len = c->p - start;
+  c->p++; // Closing quote
+  return true;
+}
+
+// Convert a number, copied into a small stack buffer for strtof
+inline bool statusParseFloat(const char *str, size_t len, float *value) {
+  if (len == 0 || len >= STATUS_NUMBER_MAX_LENGTH) return false;
+  char buf[STATUS_NUMBER_MAX_LENGTH];
+  memcpy(buf, str, len);
+  buf[len] = '\0';
+  char *parsed;
+  *value = strtof(buf, &parsed);
+  return parsed == buf + len;
+}
+
+// Read a number at the cursor
+inline bool statusReadNumber(StatusCursor *c, float *value) {
+  const uint8_t *start = c->p;
+  while (c->p < c->end && statusIsNumberChar(*c->p)) c->p++;
+  return statusParseFloat((const char *)start, c->p - start, value);
+}
+
+// Skip any value. Nesting is tracked with a counter, not recursion.
+inline bool statusSkipValue(StatusCursor *c) {
+  int depth = 0;
+  do {
+    statusSkipSpace(c);
+    if (c->p >= c->end) return false;
+    uint8_t ch = *c->p;
+    if (ch == '"') {
+      const char *s;
+      size_t n;
+      if (!statusReadString(c, &s, &n)) return false;
+    } else if (ch == '{' || ch == '[') {
+      depth++;
+      c->p++;
+    } else if (ch == '}' || ch == ']') {
+      if (depth == 0) return false;
+      depth--;
+      c->p++;
+    } else if (ch == ',' || ch == ':') {
+      if (depth == 0) return false;
+      c->p++;
+    } else {
+      // Number or literal, runs until a delimiter
+      const uint8_t *start = c->p;
+      while (c->p < c->end && !statusIsDelimiter(*c->p)) c->p++;
+      if (c->p == start) return false;
+    }
+  } while (depth > 0);
+  return true;
+}
+
+inline bool statusTokenIs(const char *str, size_t len, const char *expected) {
+  return strlen(expected) == len && memcmp(str, expected, len) == 0;
+}
+
+// Store a string field in the status. Temperatures may be sent as
+// strings ("21.0"); unknown enum values fall back to index 0, like the
+// getXxxIndexFromMQTT helpers in mqtt_config.h
+inline void statusStoreString(ACStatus *status, uint8_t field, const char *str, size_t len) {
+  int index;
+  switch (field) {
+    case STATUS_HAS_CURRENT_TEMP:
+      if (!statusParseFloat(str, len, &status->currentTemp)) return;
+      break;
+    case STATUS_HAS_SETPOINT:
+      if (!statusParseFloat(str, len, &status->setpoint)) return;
+      break;
+    case STATUS_HAS_POWER:
+      // Handle both "on"/"off" and "ON"/"OFF" cases
+      status->isOn = (len == 2 && (str[0] | 0x20) == 'o' && (str[1] | 0x20) == 'n');
+      break;
+    case STATUS_HAS_MODE:
+      index = mqttEnumDecode(MQTT_MODES, str, len);
+      status->mode = index < 0 ? 0 : index;
+      break;
+    case STATUS_HAS_FAN:
+      index = mqttEnumDecode(MQTT_FANS, str, len);
+      status->fanSpeed = index < 0 ? 0 : index;
+      break;
+    case STATUS_HAS_SWING:
+      index = mqttEnumDecode(MQTT_SWINGS, str, len);
+      status->swingMode = index < 0 ? 0 : index;
+      break;
+  }
+  status->present |= field;
+}
+
+// Map a key to its STATUS_HAS_* bit, 0 for keys we don't use
+inline uint8_t statusFieldForKey(const char *key, size_t len) {
+  switch (len) {
+    case 5:  return statusTokenIs(key, len, "power") ? STATUS_HAS_POWER : 0;
+    case 8:
+      if (statusTokenIs(key, len, "fan_mode")) return STATUS_HAS_FAN;
+      return statusTokenIs(key, len, "setpoint") ? STATUS_HAS_SETPOINT : 0;
+    case 9:  return statusTokenIs(key, len, "hvac_mode") ? STATUS_HAS_MODE : 0;
+    case 10: return statusTokenIs(key, len, "swing_mode") ? STATUS_HAS_SWING : 0;
+    case 19: return statusTokenIs(key, len, "current_temperature") ? STATUS_HAS_CURRENT_TEMP : 0;
+    default: return 0;
+  }
+}
+
+// Parse a status payload. Returns false on malformed JSON; status->present
+// then still holds the fields read before the error.
+inline bool parseStatusPayload(const uint8_t *payload, unsigned int length, ACStatus *status) {
+  StatusCursor c = {payload, payload + length};
+  status->present = 0;
+
+  statusSkipSpace(&c);
+  if (c.p >= c.end || *c.p != '{') return false;
+  c.p++;
+  statusSkipSpace(&c);
+  if (c.p < c.end && *c.p == '}') return true;
+
+  while (true) {
+    const char *key;
+    size_t keyLen;
+    statusSkipSpace(&c);
+    if (!statusReadString(&c, &key, &keyLen)) return false;
+    statusSkipSpace(&c);
+    if (c.p >= c.end || *c.p != ':') return false;
+    c.p++;
+    statusSkipSpace(&c);
+    if (c.p >= c.end) return false;
+
+    uint8_t field = statusFieldForKey(key, keyLen);
+    if (field && *c.p == '"') {
+      const char *str;
+      size_t len;
+      if (!statusReadString(&c, &str, &len)) return false;
+      statusStoreString(status, field, str, len);
+    } else if ((field == STATUS_HAS_CURRENT_TEMP || field == STATUS_HAS_SETPOINT) &&
+               (*c.p == '-' || (*c.p >= '0' && *c.p <= '9'))) {
+      float value;
+      if (!statusReadNumber(&c, &value)) return false;
+      if (field == STATUS_HAS_CURRENT_TEMP) status->currentTemp = value;
+      else status->setpoint = value;
+      status->present |= field;
+    } else if (!statusSkipValue(&c)) {
+      return false;
+    }
+
+    statusSkipSpace(&c);
+    if (c.p >= c.end) return false;
+    if (*c.p == '}') return true;
+    if (*c.p != ',') return false;
+    c.p++;
+  }
+}
+
+#endif // MQTT_STATUS_PARSER_H
@@ -0,0 +1,55 @@
+#ifndef SERIAL_LOG_H
+#define SERIAL_LOG_H
+
+// Leveled logging with a non-blocking serial sink.
+//
+// LOG_LEVEL is fixed at compile time. A LOG_* call above it expands to
+// an empty statement, arguments included, so a debug line costs nothing
+// in a build that does not log debug. Calls that are kept format into
+// the calling task's ring buffer (logWrite) and return; loop() drains the
+// rings with logFlush(), which only writes what the UART takes without
+// waiting. When a ring is full a message is dropped and counted instead.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../config/hardware_config.h"
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Implemented in ac_controller_lvgl.ino
+void logWrite(const char *format, ...) __attribute__((format(printf, 1, 2)));
+void logFlush();
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logWrite(__VA_ARGS__)
+#else
+#define LOG_ERROR(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) logWrite(__VA_ARGS__)
+#else
+#define LOG_WARN(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) logWrite(__VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logWrite(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+
+#endif // SERIAL_LOG_H
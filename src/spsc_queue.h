@@ -0,0 +1,78 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+// Lock-free single-producer/single-consumer queue of fixed size. Used
+// wherever two tasks hand data to each other: touch samples from the
+// sampler to LVGL, the messages between the network task and the UI
+// task, and each task's log output. Each side only writes its own index, so no lock is needed; the
+// release/acquire pairs make an item visible before its index moves.
+// Only std::atomic is used, the same code runs on FreeRTOS and on the
+// host with pthreads.
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, uint32_t Size>
+struct SpscQueue {
+  static_assert((Size & (Size - 1)) == 0, "SpscQueue size must be a power of two");
+  T items[Size];
+  std::atomic<uint32_t> head;  // Next slot to write, producer only
+  std::atomic<uint32_t> tail;  // Next slot to read, consumer only
+  std::atomic<uint32_t> dropped; // Items lost to a full queue, counted by the producer, read by either side
+};
+
+// Producer side. Returns false and counts the item when the queue is full.
+template <typename T, uint32_t Size>
+inline bool spscPush(SpscQueue<T, Size> *queue, const T &item) {
+  uint32_t head = queue->head.load(std::memory_order_relaxed);
+  if (head - queue->tail.load(std::memory_order_acquire) >= Size) {
+    queue->dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  queue->items[head & (Size - 1)] = item;
+  queue->head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+// Producer side. Pushes all count items, or when they do not fit none of
+// them and counts one drop.
+template <typename T, uint32_t Size>
+inline bool spscPushAll(SpscQueue<T, Size> *queue, const T *items, uint32_t count) {
+  uint32_t head = queue->head.load(std::memory_order_relaxed);
+  if (Size - (head - queue->tail.load(std::memory_order_acquire)) < count) {
+    queue->dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++) queue->items[(head + i) & (Size - 1)] = items[i];
+  queue->head.store(head + count, std::memory_order_release);
+  return true;
+}
+
+// Consumer side. Returns false when the queue is empty.
+template <typename T, uint32_t Size>
+inline bool spscPop(SpscQueue<T, Size> *queue, T *item) {
+  uint32_t tail = queue->tail.load(std::memory_order_relaxed);
+  if (tail == queue->head.load(std::memory_order_acquire)) return false;
+  *item = queue->items[tail & (Size - 1)];
+  queue->tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+// Consumer side. Pops up to max items, returns how many.
+template <typename T, uint32_t Size>
+inline uint32_t spscPopMany(SpscQueue<T, Size> *queue, T *items, uint32_t max) {
+  uint32_t tail = queue->tail.load(std::memory_order_relaxed);
+  uint32_t count = queue->head.load(std::memory_order_acquire) - tail;
+  if (count > max) count = max;
+  for (uint32_t i = 0; i < count; i++) items[i] = queue->items[(tail + i) & (Size - 1)];
+  queue->tail.store(tail + count, std::memory_order_release);
+  return count;
+}
+
+// Consumer side
+template <typename T, uint32_t Size>
+inline bool spscEmpty(SpscQueue<T, Size> *queue) {
+  return queue->tail.load(std::memory_order_relaxed) == queue->head.load(std::memory_order_acquire);
+}
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,41 @@
+#ifndef TASK_MESSAGES_H
+#define TASK_MESSAGES_H
+
+// Messages between the network task and the UI task (loop()). The
+// network task owns WiFi and PubSubClient, the UI task owns LVGL, the
+// unit state and the command queue; all they share goes through these
+// two queues, one per direction.
+//
+//   network -> UI  NetEvent    a parsed status message for a unit, or a
+//                              change of the MQTT link state
+//   UI -> network  NetCommand  a command to publish, already coalesced
+//                              and rate limited by commandQueueStep()
+
+#include <stdint.h>
+#include "../config/hardware_config.h"
+#include "spsc_queue.h"
+#include "mqtt_status_parser.h"
+
+enum NetEventType : uint8_t {
+  NET_EVENT_STATUS, // status holds the fields of one status message
+  NET_EVENT_LINK    // mqttLinkState changed, refresh the header icons
+};
+
+struct NetEvent {
+  uint8_t type;        // NET_EVENT_*
+  int8_t unitIndex;
+  uint32_t receivedAt; // millis() when the message came in
+  ACStatus status;
+};
+
+struct NetCommand {
+  int8_t unitIndex;
+  uint8_t command;     // AC_COMMAND_*
+  int16_t value;       // As in QueuedCommand
+  uint16_t seq;
+};
+
+typedef SpscQueue<NetEvent, NET_EVENT_QUEUE_SIZE> NetEventQueue;
+typedef SpscQueue<NetCommand, NET_COMMAND_QUEUE_SIZE> NetCommandQueue;
+
+#endif // TASK_MESSAGES_H
@@ -0,0 +1,142 @@
+#ifndef TOUCH_CALIBRATION_H
+#define TOUCH_CALIBRATION_H
+
+// Affine touch calibration. Raw controller coordinates are mapped to
+// screen pixels with
+//   screenX = (a * rawX + b * rawY + c) >> 16
+//   screenY = (d * rawX + e * rawY + f) >> 16
+// which covers offset, scale, skew and a rotated or mirrored panel. The
+// six coefficients come from three touched targets (Cramer's rule) and
+// are kept in NVS as a small record:
+//   magic    2 bytes  TOUCH_CAL_MAGIC
+//   version  1 byte   TOUCH_CAL_VERSION
+//   reserved 1 byte
+//   a..f     4 bytes each, int32 little endian
+//   checksum 2 bytes  Fletcher-16 over everything before it
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../config/hardware_config.h"
+#include "fletcher16.h"
+
+#define TOUCH_CAL_SHIFT 16
+#define TOUCH_CAL_MAGIC 0x7C0A
+#define TOUCH_CAL_VERSION 1
+#define TOUCH_CAL_RECORD_SIZE 30
+#define TOUCH_CAL_MIN_DET 100000L // Targets closer together than ~300 raw units per axis are rejected
+
+struct TouchCalibration {
+  int32_t a, b, c; // Screen x, TOUCH_CAL_SHIFT fraction bits
+  int32_t d, e, f; // Screen y
+};
+
+struct TouchCalPoint {
+  int16_t x;
+  int16_t y;
+};
+
+// The straight TOUCH_RAW_MIN..TOUCH_RAW_MAX mapping used before calibrating
+inline void touchCalibrationDefault(TouchCalibration *cal) {
+  cal->a = ((int32_t)TFT_WIDTH << TOUCH_CAL_SHIFT) / (TOUCH_RAW_MAX - TOUCH_RAW_MIN);
+  cal->b = 0;
+  cal->c = -cal->a * TOUCH_RAW_MIN;
+  cal->d = 0;
+  cal->e = ((int32_t)TFT_HEIGHT << TOUCH_CAL_SHIFT) / (TOUCH_RAW_MAX - TOUCH_RAW_MIN);
+  cal->f = -cal->e * TOUCH_RAW_MIN;
+}
+
+// Raw point to screen pixels, rounded; not clamped to the screen
+inline void touchCalibrationApply(const TouchCalibration *cal, int16_t rawX, int16_t rawY,
+                                  int32_t *screenX, int32_t *screenY) {
+  const int64_t half = 1 << (TOUCH_CAL_SHIFT - 1);
+  *screenX = (int32_t)(((int64_t)cal->a * rawX + (int64_t)cal->b * rawY + cal->c + half) >> TOUCH_CAL_SHIFT);
+  *screenY = (int32_t)(((int64_t)cal->d * rawX + (int64_t)cal->e * rawY + cal->f + half) >> TOUCH_CAL_SHIFT);
+}
+
+// Rounded num / den for the coefficients, den is never zero here
+inline int32_t touchCalDivide(int64_t num, int64_t den) {
+  if (den < 0) {
+    num = -num;
+    den = -den;
+  }
+  return (int32_t)((num >= 0 ? num + den / 2 : num - den / 2) / den);
+}
+
+// Solve the transform from three raw points and the targets they belong
+// to. Returns false, leaving cal untouched, when the points are (almost)
+// on one line or give a scale no real panel has.
+inline bool touchCalibrationCompute(const TouchCalPoint raw[3], const TouchCalPoint screen[3],
+                                    TouchCalibration *cal) {
+  int64_t x0 = raw[0].x - raw[2].x, y0 = raw[0].y - raw[2].y;
+  int64_t x1 = raw[1].x - raw[2].x, y1 = raw[1].y - raw[2].y;
+  int64_t det = x0 * y1 - x1 * y0;
+  if (det > -TOUCH_CAL_MIN_DET && det < TOUCH_CAL_MIN_DET) return false;
+
+  int64_t sx0 = screen[0].x - screen[2].x, sx1 = screen[1].x - screen[2].x;
+  int64_t sy0 = screen[0].y - screen[2].y, sy1 = screen[1].y - screen[2].y;
+
+  TouchCalibration result;
+  result.a = touchCalDivide((sx0 * y1 - sx1 * y0) << TOUCH_CAL_SHIFT, det);
+  result.b = touchCalDivide((x0 * sx1 - x1 * sx0) << TOUCH_CAL_SHIFT, det);
+  result.d = touchCalDivide((sy0 * y1 - sy1 * y0) << TOUCH_CAL_SHIFT, det);
+  result.e = touchCalDivide((x0 * sy1 - x1 * sy0) << TOUCH_CAL_SHIFT, det);
+
+  // The 12-bit controller spans the whole panel, so one raw unit is
+  // always well below one pixel
+  const int32_t one = 1 << TOUCH_CAL_SHIFT;
+  if (result.a >= one || result.a <= -one || result.b >= one || result.b <= -one ||
+      result.d >= one || result.d <= -one || result.e >= one || result.e <= -one) {
+    return false;
+  }
+
+  result.c = ((int32_t)screen[2].x << TOUCH_CAL_SHIFT) - result.a * raw[2].x - result.b * raw[2].y;
+  result.f = ((int32_t)screen[2].y << TOUCH_CAL_SHIFT) - result.d * raw[2].x - result.e * raw[2].y;
+  *cal = result;
+  return true;
+}
+
+// Write the record into buf, which must hold TOUCH_CAL_RECORD_SIZE bytes
+inline size_t encodeTouchCalibration(const TouchCalibration *cal, uint8_t *buf) {
+  const int32_t values[6] = {cal->a, cal->b, cal->c, cal->d, cal->e, cal->f};
+  buf[0] = TOUCH_CAL_MAGIC & 0xFF;
+  buf[1] = TOUCH_CAL_MAGIC >> 8;
+  buf[2] = TOUCH_CAL_VERSION;
+  buf[3] = 0;
+  uint8_t *p = buf + 4;
+  for (uint8_t i = 0; i < 6; i++) {
+    uint32_t v = (uint32_t)values[i];
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+    p += 4;
+  }
+  uint16_t sum = fletcher16(buf, p - buf);
+  p[0] = sum & 0xFF;
+  p[1] = sum >> 8;
+  return TOUCH_CAL_RECORD_SIZE;
+}
+
+// Returns false, leaving cal untouched, for a damaged or foreign record
+inline bool decodeTouchCalibration(const uint8_t *buf, size_t length, TouchCalibration *cal) {
+  if (length != TOUCH_CAL_RECORD_SIZE) return false;
+  if ((buf[0] | (buf[1] << 8)) != TOUCH_CAL_MAGIC || buf[2] != TOUCH_CAL_VERSION) return false;
+  uint16_t sum = buf[TOUCH_CAL_RECORD_SIZE - 2] | (buf[TOUCH_CAL_RECORD_SIZE - 1] << 8);
+  if (sum != fletcher16(buf, TOUCH_CAL_RECORD_SIZE - 2)) return false;
+
+  int32_t values[6];
+  const uint8_t *p = buf + 4;
+  for (uint8_t i = 0; i < 6; i++) {
+    values[i] = (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+    p += 4;
+  }
+  cal->a = values[0];
+  cal->b = values[1];
+  cal->c = values[2];
+  cal->d = values[3];
+  cal->e = values[4];
+  cal->f = values[5];
+  return true;
+}
+
+#endif // TOUCH_CALIBRATION_H
@@ -0,0 +1,133 @@
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+// Filter pipeline for raw touch samples, run per touch event (pen down
+// to pen up) on the samples from the touch ring:
+//   1. pressure rejection  samples below TOUCH_PRESSURE_MIN are dropped,
+//                          light contact at the start and end of a touch
+//                          is where the controller is least accurate
+//   2. oversampling        TOUCH_OVERSAMPLE samples are averaged into one
+//   3. median              per axis over the last TOUCH_MEDIAN_SIZE points,
+//                          removes single-sample spikes
+//   4. IIR                 y += (x - y) * TOUCH_IIR_ALPHA / 256, kept with
+//                          4 fraction bits so slow moves are not lost
+// Integer only, a few dozen operations per sample. All state is reset
+// when the pen lifts, so one touch never drags into the next.
+
+#include <stdint.h>
+#include "../config/hardware_config.h"
+#include "touch_ring.h"
+
+#define TOUCH_IIR_FRACTION_BITS 4
+
+static_assert(TOUCH_OVERSAMPLE >= 1, "TOUCH_OVERSAMPLE must be at least 1");
+static_assert(TOUCH_MEDIAN_SIZE >= 1 && TOUCH_MEDIAN_SIZE <= 7, "TOUCH_MEDIAN_SIZE must be 1 to 7");
+static_assert(TOUCH_IIR_ALPHA >= 1 && TOUCH_IIR_ALPHA <= 256, "TOUCH_IIR_ALPHA must be 1 to 256");
+
+struct TouchFilter {
+  bool active;                         // A touch is in progress and produced output
+  int32_t sumX, sumY, sumZ;            // Oversampling group being collected
+  uint8_t groupCount;
+  int16_t medianX[TOUCH_MEDIAN_SIZE];  // Last averaged points, circular
+  int16_t medianY[TOUCH_MEDIAN_SIZE];
+  uint8_t medianCount;
+  uint8_t medianNext;
+  int32_t iirX, iirY;                  // Filter output, TOUCH_IIR_FRACTION_BITS fraction bits
+  uint32_t rejected;                   // Samples dropped for low pressure, for statistics
+};
+
+inline void touchFilterReset(TouchFilter *f) {
+  f->active = false;
+  f->sumX = f->sumY = f->sumZ = 0;
+  f->groupCount = 0;
+  f->medianCount = 0;
+  f->medianNext = 0;
+}
+
+// Median of the first count values; insertion sort on a copy, count <= 7.
+// An even count (a full window of even TOUCH_MEDIAN_SIZE) averages the
+// middle two.
+inline int16_t touchMedian(const int16_t *values, uint8_t count) {
+  int16_t sorted[TOUCH_MEDIAN_SIZE];
+  for (uint8_t i = 0; i < count; i++) {
+    int16_t v = values[i];
+    uint8_t j = i;
+    while (j > 0 && sorted[j - 1] > v) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = v;
+  }
+  if ((count & 1) == 0) return (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+  return sorted[count / 2];
+}
+
+// Stages 3 and 4 for one averaged point, writes the filtered point to out
+inline void touchFilterPoint(TouchFilter *f, int16_t x, int16_t y, int16_t z, TouchSample *out) {
+  f->medianX[f->medianNext] = x;
+  f->medianY[f->medianNext] = y;
+  f->medianNext = (f->medianNext + 1) % TOUCH_MEDIAN_SIZE;
+  if (f->medianCount < TOUCH_MEDIAN_SIZE) f->medianCount++;
+  // While the window fills up, an even count leaves out the newest point:
+  // averaging two points would pass half of a spike right at the start
+  uint8_t count = f->medianCount < TOUCH_MEDIAN_SIZE ? ((f->medianCount - 1) | 1) : f->medianCount;
+  int32_t mx = (int32_t)touchMedian(f->medianX, count) << TOUCH_IIR_FRACTION_BITS;
+  int32_t my = (int32_t)touchMedian(f->medianY, count) << TOUCH_IIR_FRACTION_BITS;
+
+  if (!f->active) {
+    // First point of a touch starts the IIR where the finger is
+    f->iirX = mx;
+    f->iirY = my;
+    f->active = true;
+  } else {
+    f->iirX += ((mx - f->iirX) * TOUCH_IIR_ALPHA) >> 8;
+    f->iirY += ((my - f->iirY) * TOUCH_IIR_ALPHA) >> 8;
+  }
+
+  const int32_t half = 1 << (TOUCH_IIR_FRACTION_BITS - 1);
+  out->x = (int16_t)((f->iirX + half) >> TOUCH_IIR_FRACTION_BITS);
+  out->y = (int16_t)((f->iirY + half) >> TOUCH_IIR_FRACTION_BITS);
+  out->z = z;
+  out->down = true;
+}
+
+// Feed one raw sample. Writes up to two samples to out and returns how
+// many: nothing while a group fills, one filtered point per full group,
+// and on pen up the point of a partial group (so a short tap still
+// lands) followed by the release.
+inline uint8_t touchFilterFeed(TouchFilter *f, const TouchSample &in, TouchSample out[2]) {
+  uint8_t count = 0;
+
+  if (!in.down) {
+    if (f->groupCount > 0) {
+      touchFilterPoint(f, f->sumX / f->groupCount, f->sumY / f->groupCount,
+                       f->sumZ / f->groupCount, &out[count]);
+      out[count++].at = in.at;
+    }
+    if (f->active) {
+      out[count] = in;
+      count++;
+    }
+    touchFilterReset(f);
+    return count;
+  }
+
+  if (in.z < TOUCH_PRESSURE_MIN) {
+    f->rejected++;
+    return 0;
+  }
+
+  f->sumX += in.x;
+  f->sumY += in.y;
+  f->sumZ += in.z;
+  if (++f->groupCount < TOUCH_OVERSAMPLE) return 0;
+
+  touchFilterPoint(f, f->sumX / TOUCH_OVERSAMPLE, f->sumY / TOUCH_OVERSAMPLE,
+                   f->sumZ / TOUCH_OVERSAMPLE, &out[0]);
+  out[0].at = in.at;
+  f->sumX = f->sumY = f->sumZ = 0;
+  f->groupCount = 0;
+  return 1;
+}
+
+#endif // TOUCH_FILTER_H
@@ -0,0 +1,21 @@
+#ifndef TOUCH_RING_H
+#define TOUCH_RING_H
+
+// Raw touch samples from the touch sampler (esp_timer task, producer) to
+// my_touchpad_read (LVGL, loop task, consumer), see src/spsc_queue.h.
+
+#include <stdint.h>
+#include "../config/hardware_config.h"
+#include "spsc_queue.h"
+
+struct TouchSample {
+  int16_t x;     // Raw controller coordinates
+  int16_t y;
+  int16_t z;     // Pressure
+  bool down;     // false marks the pen lifting, x/y are not valid then
+  uint32_t at;   // millis() when sampled
+};
+
+typedef SpscQueue<TouchSample, TOUCH_RING_SIZE> TouchRing;
+
+#endif // TOUCH_RING_H
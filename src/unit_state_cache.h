@@ -0,0 +1,121 @@
+#ifndef UNIT_STATE_CACHE_H
+#define UNIT_STATE_CACHE_H
+
+// Compact binary snapshot of the unit state, stored in flash so a warm
+// boot shows the last known values instead of the compiled-in defaults.
+//
+// Record layout, little endian:
+//   magic    2 bytes  UNIT_STATE_MAGIC
+//   version  1 byte   UNIT_STATE_VERSION
+//   count    1 byte   number of units
+//   layout   4 bytes  hash of the unit topics, the record is ignored when
+//                     units were added, removed or reordered
+//   units    6 bytes each:
+//     currentTemp  int16, tenths of a degree, UNIT_STATE_TEMP_UNKNOWN if unknown
+//     targetTemp   int16, tenths of a degree
+//     flags        uint16, bit 0 power, bits 1-3 mode, 4-5 fan, 6-8 swing
+//   checksum 2 bytes  Fletcher-16 over everything before it
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "ac_controller_lvgl.h"
+#include "fletcher16.h"
+
+#define UNIT_STATE_MAGIC 0xAC5E
+#define UNIT_STATE_VERSION 1
+#define UNIT_STATE_HEADER_SIZE 8
+#define UNIT_STATE_UNIT_SIZE 6
+#define UNIT_STATE_TEMP_UNKNOWN INT16_MIN
+
+constexpr size_t unitStateRecordSize(int count) {
+  return UNIT_STATE_HEADER_SIZE + count * UNIT_STATE_UNIT_SIZE + 2;
+}
+
+inline void unitStatePut16(uint8_t *p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+inline uint16_t unitStateGet16(const uint8_t *p) {
+  return p[0] | (p[1] << 8);
+}
+
+// FNV-1a over all unit topics, identifies the unit list a record belongs to
+inline uint32_t unitStateLayout(const ACUnit *units, int count) {
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < count; i++) {
+    for (const char *p = units[i].mqttTopic; *p; p++) {
+      hash = (hash ^ (uint8_t)*p) * 16777619u;
+    }
+    hash = (hash ^ '/') * 16777619u;
+  }
+  return hash;
+}
+
+inline int16_t unitStateEncodeTemp(float temp) {
+  if (isnan(temp)) return UNIT_STATE_TEMP_UNKNOWN;
+  return (int16_t)lroundf(temp * 10);
+}
+
+inline float unitStateDecodeTemp(int16_t value) {
+  return value == UNIT_STATE_TEMP_UNKNOWN ? AC_TEMP_UNKNOWN : value / 10.0f;
+}
+
+// Write the record for all units into buf, which must hold unitStateRecordSize(count) bytes
+inline size_t encodeUnitState(const ACUnit *units, int count, uint8_t *buf) {
+  uint8_t *p = buf;
+  unitStatePut16(p, UNIT_STATE_MAGIC);
+  p[2] = UNIT_STATE_VERSION;
+  p[3] = count;
+  uint32_t layout = unitStateLayout(units, count);
+  unitStatePut16(p + 4, layout & 0xFFFF);
+  unitStatePut16(p + 6, layout >> 16);
+  p += UNIT_STATE_HEADER_SIZE;
+
+  for (int i = 0; i < count; i++) {
+    const ACUnit *unit = &units[i];
+    uint16_t flags = (unit->isOn ? 1 : 0) | ((unit->mode & 0x07) << 1) |
+                     ((unit->fanSpeed & 0x03) << 4) | ((unit->swingMode & 0x07) << 6);
+    unitStatePut16(p, (uint16_t)unitStateEncodeTemp(unit->currentTemp));
+    unitStatePut16(p + 2, (uint16_t)unitStateEncodeTemp(unit->targetTemp));
+    unitStatePut16(p + 4, flags);
+    p += UNIT_STATE_UNIT_SIZE;
+  }
+
+  unitStatePut16(p, fletcher16(buf, p - buf));
+  return p + 2 - buf;
+}
+
+// Restore the units from a record. Returns false, leaving the units
+// untouched, when the record is damaged, from another version or for
+// another unit list.
+inline bool decodeUnitState(const uint8_t *buf, size_t length, ACUnit *units, int count) {
+  size_t expected = unitStateRecordSize(count);
+  if (length != expected) return false;
+  if (unitStateGet16(buf) != UNIT_STATE_MAGIC || buf[2] != UNIT_STATE_VERSION || buf[3] != count) return false;
+  uint32_t layout = unitStateGet16(buf + 4) | ((uint32_t)unitStateGet16(buf + 6) << 16);
+  if (layout != unitStateLayout(units, count)) return false;
+  if (unitStateGet16(buf + expected - 2) != fletcher16(buf, expected - 2)) return false;
+
+  const uint8_t *p = buf + UNIT_STATE_HEADER_SIZE;
+  for (int i = 0; i < count; i++) {
+    ACUnit *unit = &units[i];
+    uint16_t flags = unitStateGet16(p + 4);
+    unit->currentTemp = unitStateDecodeTemp((int16_t)unitStateGet16(p));
+    unit->targetTemp = unitStateDecodeTemp((int16_t)unitStateGet16(p + 2));
+    unit->isOn = flags & 1;
+    unit->mode = (flags >> 1) & 0x07;
+    unit->fanSpeed = (flags >> 4) & 0x03;
+    unit->swingMode = (flags >> 6) & 0x07;
+    // Values from an older firmware may be out of range for this one
+    if (unit->mode > 4) unit->mode = 0;
+    if (unit->swingMode > 4) unit->swingMode = 0;
+    if (isnan(unit->targetTemp)) unit->targetTemp = 22.0;
+    p += UNIT_STATE_UNIT_SIZE;
+  }
+  return true;
+}
+
+#endif // UNIT_STATE_CACHE_H